@@ -0,0 +1,7 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Benchmark.cpp
+ * This file contains the benchmark main cpp
+ **/
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,70 @@
+/* Copyright (c) 2021 [Rick de Bondt] - BenchmarkHelpers.cpp */
+
+#include "BenchmarkHelpers.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "PCapWrapper.h"
+
+namespace
+{
+    std::atomic<uint64_t> gAllocationCount{0};
+}  // namespace
+
+// Counts every allocation, so benchmarks can report how many allocations a single packet costs
+void* operator new(std::size_t aSize)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    void* lReturn{std::malloc(aSize == 0 ? 1 : aSize)};
+    if (lReturn == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return lReturn;
+}
+
+void operator delete(void* aPointer) noexcept
+{
+    std::free(aPointer);
+}
+
+void operator delete(void* aPointer, std::size_t /*aSize*/) noexcept
+{
+    std::free(aPointer);
+}
+
+uint64_t GetAllocationCount()
+{
+    return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+std::vector<std::string> ReadPackets(std::string_view aFileName)
+{
+    std::vector<std::string> lReturn{};
+
+    const std::string lPath{std::string(BenchmarkHelpers_Constants::cInputFolder) + std::string(aFileName)};
+    std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+    PCapWrapper                        lWrapper{};
+
+    if (lWrapper.OpenOffline(lPath.c_str(), lErrorBuffer.data()) != nullptr) {
+        pcap_pkthdr*         lHeader{nullptr};
+        const unsigned char* lData{nullptr};
+        while (lWrapper.NextEx(&lHeader, &lData) > 0) {
+            lReturn.emplace_back(reinterpret_cast<const char*>(lData), lHeader->caplen);
+        }
+        lWrapper.Close();
+    }
+
+    return lReturn;
+}
+
+void SetPacketCounters(benchmark::State& aState, uint64_t aAllocations)
+{
+    aState.SetItemsProcessed(aState.iterations());
+    aState.counters["allocations/packet"] =
+        benchmark::Counter(static_cast<double>(aAllocations), benchmark::Counter::kAvgIterations);
+}
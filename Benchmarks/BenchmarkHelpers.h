@@ -0,0 +1,45 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - BenchmarkHelpers.h
+ *
+ * This file contains helpers shared by all the benchmarks.
+ *
+ **/
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace BenchmarkHelpers_Constants
+{
+    // Benchmarks are run from the build folder, just like the unittests
+    constexpr std::string_view cInputFolder{"../Tests/Input/"};
+    // Files the benchmarks write go where the unittests write theirs
+    constexpr std::string_view cOutputFolder{"../Tests/Output/"};
+    // Everything talks over loopback, so nothing leaves the machine
+    constexpr std::string_view cIp{"127.0.0.1"};
+}  // namespace BenchmarkHelpers_Constants
+
+/**
+ * Gets the amount of heap allocations done by the program so far, counted by the global operator new in
+ * BenchmarkHelpers.cpp.
+ * @return the amount of allocations.
+ */
+uint64_t GetAllocationCount();
+
+/**
+ * Reads all packets from one of the capture files the unittests use as input.
+ * @param aFileName - Name of the file in Tests/Input.
+ * @return the packets in the order they were captured, empty if the file could not be read.
+ */
+std::vector<std::string> ReadPackets(std::string_view aFileName);
+
+/**
+ * Reports the amount of packets handled and the average amount of allocations per packet.
+ * @param aState - State of the benchmark that ran.
+ * @param aAllocations - Amount of allocations done while running the benchmark.
+ */
+void SetPacketCounters(benchmark::State& aState, uint64_t aAllocations);
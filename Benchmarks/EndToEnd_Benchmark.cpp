@@ -0,0 +1,495 @@
+/* Copyright (c) 2021 [Rick de Bondt] - EndToEnd_Benchmark.cpp
+ * This file contains benchmarks that send packets through a device and XLinkKaiConnection to a local XLink Kai
+ * stand-in and back, to find out how many packets per second the program can handle and how long they take.
+ **/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "IWifiInterface.h"
+#include "MonitorDevice.h"
+#include "NetConversionFunctions.h"
+#include "PCapWrapper.h"
+#include "WirelessPSPPluginDevice.h"
+#include "WirelessPromiscuousDevice.h"
+#include "XLinkKaiConnection.h"
+#include "XLinkKaiStandIn.h"
+
+using namespace std::chrono;
+using namespace WirelessPromiscuousBase_Constants;
+
+namespace
+{
+    constexpr milliseconds     cConnectTimeout{5000};
+    // Packets that did not arrive after the last one has been quiet for this long are counted as dropped
+    constexpr milliseconds     cSettleTime{200};
+    // Marks the packets that carry a sequence number, so the ones that were in the capture already are left alone
+    constexpr uint32_t         cSequenceMagic{0x5845424e};
+    constexpr size_t           cStampLength{sizeof(cSequenceMagic) + sizeof(uint32_t)};
+    constexpr std::string_view cAdapterName{"wlan0"};
+    // Frame control flag of encrypted 802.11 frames
+    constexpr uint8_t          cProtectedFlag{0x40};
+
+    /**
+     * The devices that can be benchmarked, used as first argument of the benchmarks.
+     **/
+    enum DeviceKind
+    {
+        Promiscuous = 0,
+        Plugin,
+        Monitor
+    };
+
+    /**
+     * Capture files the devices get to work with, the device file is played back as if it was captured by the
+     * adapter, the XLink Kai file is sent by the stand-in. Some devices keep bytes behind the payload that do not
+     * make it across, the sequence number goes in front of those.
+     **/
+    struct DeviceFiles
+    {
+        std::string_view device;
+        std::string_view xlinkkai;
+        int              linktype;
+        size_t           capturedtrailer;
+        size_t           senttrailer;
+    };
+
+    // The plugin keeps the Mac address it replaced at the end, frames in monitor mode are captured with their FCS
+    constexpr std::array<DeviceFiles, 3> cDeviceFiles{
+        {{"PromiscuousTestDevice.pcap", "PromiscuousTestXLink.pcap", DLT_EN10MB, 0, 0},
+         {"PluginFromPSPTest.pcapng",
+          "PluginFromXLinkTest.pcapng",
+          DLT_EN10MB,
+          Net_8023_Constants::cDestinationAddressLength,
+          Net_8023_Constants::cSourceAddressLength},
+         {"MonitorHelloWorld.pcapng", "PromiscuousHelloWorld.pcapng", DLT_IEEE802_11_RADIO, sizeof(uint32_t), 0}}};
+
+    /**
+     * Keeps the send and receive time of every packet, packets are recognized by a sequence number in their last
+     * bytes.
+     **/
+    class LatencyRecorder
+    {
+    public:
+        explicit LatencyRecorder(size_t aAmountOfPackets) : mSent(aAmountOfPackets), mReceived(aAmountOfPackets) {}
+
+        /**
+         * Makes a copy of a packet for every sequence number, cycling through the given packets.
+         * @param aPackets - Packets to copy.
+         * @param aIsForwarded - Tells which packets make it through the device, others are skipped.
+         * @param aTrailerLength - Amount of bytes to leave alone at the end of the packets.
+         * @return the packets with sequence number.
+         */
+        [[nodiscard]] std::vector<std::string> Stamp(const std::vector<std::string>&               aPackets,
+                                                     const std::function<bool(std::string_view)>& aIsForwarded,
+                                                     size_t aTrailerLength = 0) const
+        {
+            std::vector<std::string> lUsable{};
+            std::copy_if(
+                aPackets.begin(), aPackets.end(), std::back_inserter(lUsable), [&](const std::string& aPacket) {
+                    return aPacket.size() >= Net_8023_Constants::cHeaderLength + cStampLength + aTrailerLength &&
+                           aIsForwarded(aPacket);
+                });
+
+            std::vector<std::string> lReturn{};
+            for (uint32_t lSequence = 0; !lUsable.empty() && lSequence < mSent.size(); lSequence++) {
+                std::string lPacket{lUsable.at(lSequence % lUsable.size())};
+                char*       lStamp{lPacket.data() + lPacket.size() - aTrailerLength - cStampLength};
+                memcpy(lStamp, &cSequenceMagic, sizeof(cSequenceMagic));
+                memcpy(lStamp + sizeof(cSequenceMagic), &lSequence, sizeof(lSequence));
+                lReturn.push_back(std::move(lPacket));
+            }
+
+            return lReturn;
+        }
+
+        void MarkSent(std::string_view aPacket, size_t aTrailerLength = 0) { Mark(mSent, aPacket, aTrailerLength); }
+
+        void MarkReceived(std::string_view aPacket, size_t aTrailerLength = 0)
+        {
+            if (Mark(mReceived, aPacket, aTrailerLength)) {
+                mReceivedCount++;
+            }
+        }
+
+        /**
+         * Waits until all packets arrived, or nothing arrived for a while.
+         */
+        void WaitForReceived()
+        {
+            size_t lLastCount{0};
+            auto   lLastChange{steady_clock::now()};
+            while (mReceivedCount < mReceived.size() && steady_clock::now() - lLastChange < cSettleTime) {
+                std::this_thread::sleep_for(milliseconds(1));
+                if (mReceivedCount != lLastCount) {
+                    lLastCount  = mReceivedCount;
+                    lLastChange = steady_clock::now();
+                }
+            }
+        }
+
+        /**
+         * Reports throughput, the latency distribution and drops of everything that was sent.
+         * @param aState - State of the benchmark to report to.
+         */
+        void Report(benchmark::State& aState)
+        {
+            std::vector<int64_t> lLatencies{};
+            int64_t              lFirstSent{INT64_MAX};
+            int64_t              lLastReceived{0};
+
+            for (size_t lCount = 0; lCount < mSent.size(); lCount++) {
+                const int64_t lSent{mSent.at(lCount)};
+                const int64_t lReceived{mReceived.at(lCount)};
+                if (lSent != 0) {
+                    lFirstSent = std::min(lFirstSent, lSent);
+                }
+                if (lSent != 0 && lReceived != 0) {
+                    lLatencies.push_back(lReceived - lSent);
+                    lLastReceived = std::max(lLastReceived, lReceived);
+                }
+            }
+
+            const double lSeconds{
+                lLatencies.empty() ? 0.0 : duration<double>(nanoseconds(lLastReceived - lFirstSent)).count()};
+            aState.SetIterationTime(lSeconds);
+            aState.counters["packets/s"] =
+                lSeconds > 0 ? static_cast<double>(lLatencies.size()) / lSeconds : 0.0;
+            aState.counters["dropped"] = static_cast<double>(mSent.size() - lLatencies.size());
+
+            if (!lLatencies.empty()) {
+                std::sort(lLatencies.begin(), lLatencies.end());
+                aState.counters["p50_us"] = static_cast<double>(lLatencies.at(lLatencies.size() / 2)) / 1000.0;
+                aState.counters["p99_us"] = static_cast<double>(lLatencies.at(lLatencies.size() * 99 / 100)) / 1000.0;
+                aState.counters["max_us"] = static_cast<double>(lLatencies.back()) / 1000.0;
+            }
+        }
+
+    private:
+        static bool Mark(std::vector<std::atomic<int64_t>>& aTimes, std::string_view aPacket, size_t aTrailerLength)
+        {
+            bool lReturn{false};
+
+            uint32_t lMagic{0};
+            uint32_t lSequence{0};
+            if (aPacket.size() >= cStampLength + aTrailerLength) {
+                const char* lStamp{aPacket.data() + aPacket.size() - aTrailerLength - cStampLength};
+                memcpy(&lMagic, lStamp, sizeof(lMagic));
+                memcpy(&lSequence, lStamp + sizeof(lMagic), sizeof(lSequence));
+            }
+
+            if (lMagic == cSequenceMagic && lSequence < aTimes.size()) {
+                aTimes.at(lSequence) = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+                lReturn              = true;
+            }
+
+            return lReturn;
+        }
+
+        std::vector<std::atomic<int64_t>> mSent;
+        std::vector<std::atomic<int64_t>> mReceived;
+        std::atomic<size_t>               mReceivedCount{0};
+    };
+
+    /**
+     * PCapWrapper that plays back a capture file instead of capturing on an adapter, everything the device captures
+     * or sends still goes through the real wrapper, the device can't tell the difference.
+     **/
+    class PlaybackWrapper : public PCapWrapper
+    {
+    public:
+        PlaybackWrapper(std::string aFileName, const DeviceFiles& aFiles, LatencyRecorder& aRecorder) :
+            mFileName(std::move(aFileName)), mFiles(aFiles), mRecorder(aRecorder)
+        {}
+
+        pcap_t* Create(const char* /*source*/, char* errbuf) override { return OpenOffline(mFileName.c_str(), errbuf); }
+
+        int Activate() override { return IsActivated() ? 0 : PCAP_ERROR; }
+
+        int Dispatch(int cnt, pcap_handler callback, unsigned char* user) override
+        {
+            mCallback = callback;
+            mUser     = user;
+
+            const int lReturn{PCapWrapper::Dispatch(cnt, &PlaybackWrapper::Captured, reinterpret_cast<u_char*>(this))};
+            if (lReturn == 0) {
+                // A live capture waits for packets up to its timeout, at the end of the file the device would spin
+                mPlayedBack = true;
+                std::this_thread::sleep_for(milliseconds(cPCAPTimeoutMs));
+            }
+
+            return lReturn;
+        }
+
+        // A capture file can't be waited on, the device falls back to polling
+        int GetSelectableFd() override { return -1; }
+
+        int SendPacket(std::string_view buffer) override
+        {
+            mRecorder.MarkReceived(buffer, mFiles.senttrailer);
+            return 0;
+        }
+
+        int SendBatch(std::span<const std::string> buffers) override
+        {
+            for (const auto& lBuffer : buffers) {
+                mRecorder.MarkReceived(lBuffer, mFiles.senttrailer);
+            }
+            return static_cast<int>(buffers.size());
+        }
+
+        // Settings of a live capture, there is nothing to set on a capture file
+        int SetBufferSize(int /*buffer_size*/) override { return 0; }
+        int SetDirection(PcapDirection::Direction /*direction*/) override { return 0; }
+        int SetImmediateMode(int /*mode*/) override { return 0; }
+        int SetNonBlock(int /*nonblock*/) override { return 0; }
+        int SetSnapLen(int /*snaplen*/) override { return 0; }
+        int SetTimeOut(int /*timeout*/) override { return 0; }
+
+        /**
+         * @return true once the device read the whole capture file.
+         */
+        [[nodiscard]] bool IsPlayedBack() const { return mPlayedBack; }
+
+    private:
+        static void Captured(unsigned char* aThis, const pcap_pkthdr* aHeader, const unsigned char* aPacket)
+        {
+            auto* lThis{reinterpret_cast<PlaybackWrapper*>(aThis)};
+            lThis->mRecorder.MarkSent(std::string_view(reinterpret_cast<const char*>(aPacket), aHeader->caplen),
+                                      lThis->mFiles.capturedtrailer);
+            lThis->mCallback(lThis->mUser, aHeader, aPacket);
+        }
+
+        std::string        mFileName;
+        const DeviceFiles& mFiles;
+        LatencyRecorder&   mRecorder;
+        pcap_handler       mCallback{nullptr};
+        unsigned char*     mUser{nullptr};
+        std::atomic<bool>  mPlayedBack{false};
+    };
+
+    /**
+     * Wifi adapter that is always connected, with a Mac address that is not in any of the capture files.
+     **/
+    class StandInWifiInterface : public IWifiInterface
+    {
+    public:
+        bool Connect(const WifiInformation& /*aConnection*/) override { return true; }
+        bool LeaveIBSS() override { return true; }
+        uint64_t GetAdapterMacAddress() override { return MacToInt("02:00:00:00:00:01"); }
+        std::vector<WifiInformation>& GetAdhocNetworks() override { return mNetworks; }
+
+    private:
+        std::vector<WifiInformation> mNetworks{};
+    };
+
+    /**
+     * Writes the packets a device gets to capture, the capture file as is first so the device can find the network
+     * like it normally would.
+     * @param aKind - The device that is going to play it back.
+     * @param aStamped - Packets with a sequence number to add after that.
+     * @return the path to the written file.
+     */
+    std::string WritePlayback(DeviceKind aKind, const std::vector<std::string>& aStamped)
+    {
+        const std::string lPath{std::string(BenchmarkHelpers_Constants::cOutputFolder) + "EndToEndPlayback.pcap"};
+
+        std::vector<std::string> lPackets{ReadPackets(cDeviceFiles.at(aKind).device)};
+        lPackets.insert(lPackets.end(), aStamped.begin(), aStamped.end());
+
+        PCapWrapper lWrapper{};
+        lWrapper.OpenDead(cDeviceFiles.at(aKind).linktype, cSnapshotLength);
+        pcap_dumper_t* lDumper{lWrapper.DumpOpen(lPath.c_str())};
+        if (lDumper != nullptr) {
+            for (auto& lPacket : lPackets) {
+                pcap_pkthdr lHeader{};
+                lHeader.caplen = lPacket.size();
+                lHeader.len    = lPacket.size();
+                lWrapper.Dump(reinterpret_cast<unsigned char*>(lDumper),
+                              &lHeader,
+                              reinterpret_cast<unsigned char*>(lPacket.data()));
+            }
+            lWrapper.DumpClose(lDumper);
+        }
+        lWrapper.Close();
+
+        return lPath;
+    }
+
+    /**
+     * Tells if a packet from the capture of the device would be converted and sent to XLink Kai.
+     * @param aKind - The device that captures it.
+     * @param aPacket - The packet.
+     * @return true if the packet should make it to XLink Kai.
+     */
+    bool IsForwarded(DeviceKind aKind, std::string_view aPacket)
+    {
+        bool lReturn{true};
+
+        if (aKind == Plugin) {
+            // Broadcasts from the plugin are answered with a handshake instead
+            lReturn = (GetRawData<uint64_t>(aPacket, Net_8023_Constants::cDestinationAddressIndex) &
+                       Net_Constants::cBroadcastMac) != Net_Constants::cBroadcastMac;
+        } else if (aKind == Monitor) {
+            // Only data frames that are not retries and not encrypted get converted
+            const auto    lRadioTapLength{GetRawData<uint16_t>(aPacket, RadioTap_Constants::cLengthIndex)};
+            const uint8_t lType{static_cast<uint8_t>(aPacket.at(lRadioTapLength))};
+            const uint8_t lFlags{static_cast<uint8_t>(aPacket.at(lRadioTapLength + 1))};
+            lReturn = (lType == Net_80211_Constants::cDataType || lType == Net_80211_Constants::cDataQOSType) &&
+                      (lFlags & (Net_80211_Constants::cDataRetryFlag | cProtectedFlag)) == 0;
+        }
+
+        return lReturn;
+    }
+
+    /**
+     * Creates and opens a device on top of a playback wrapper.
+     * @param aKind - The device to create.
+     * @param aWrapper - The wrapper the device captures and sends on.
+     * @return the device, nullptr if it could not be opened.
+     */
+    std::shared_ptr<IPCapDevice> OpenDevice(DeviceKind aKind, const std::shared_ptr<PlaybackWrapper>& aWrapper)
+    {
+        std::shared_ptr<IPCapDevice> lReturn{nullptr};
+
+        // The stand-in file for monitor mode is captured on this network
+        std::vector<std::string> lSSIDFilter{aKind == Monitor ? "T#STNET" : ""};
+        bool                     lOpened{false};
+
+        switch (aKind) {
+            case Promiscuous: {
+                auto lDevice{std::make_shared<WirelessPromiscuousDevice>(
+                    false, cReconnectionTimeOut, nullptr, std::make_shared<Handler8023>(), aWrapper)};
+                lOpened = lDevice->Open(cAdapterName, lSSIDFilter, std::make_shared<StandInWifiInterface>());
+                lReturn = lDevice;
+                break;
+            }
+            case Plugin: {
+                auto lDevice{std::make_shared<WirelessPSPPluginDevice>(
+                    false, cReconnectionTimeOut, nullptr, std::make_shared<HandlerPSPPlugin>(), aWrapper)};
+                lOpened = lDevice->Open(cAdapterName, lSSIDFilter, std::make_shared<StandInWifiInterface>());
+                lReturn = lDevice;
+                break;
+            }
+            case Monitor: {
+                auto lDevice{std::make_shared<MonitorDevice>(0, false, nullptr, aWrapper)};
+                lOpened = lDevice->Open(cAdapterName, lSSIDFilter);
+                lReturn = lDevice;
+                break;
+            }
+        }
+
+        return lOpened ? lReturn : nullptr;
+    }
+}  // namespace
+
+// Packets captured by a device, converted and sent to XLink Kai, with the device and amount of packets as arguments.
+static void EndToEndDeviceToXLinkKai(benchmark::State& aState)
+{
+    const auto         lKind{static_cast<DeviceKind>(aState.range(0))};
+    const DeviceFiles& lFiles{cDeviceFiles.at(lKind)};
+
+    for ([[maybe_unused]] auto lIterator : aState) {
+        LatencyRecorder                lRecorder{static_cast<size_t>(aState.range(1))};
+        const std::vector<std::string> lPackets{
+            lRecorder.Stamp(ReadPackets(lFiles.device),
+                            [lKind](std::string_view aPacket) { return IsForwarded(lKind, aPacket); },
+                            lFiles.capturedtrailer)};
+
+        XLinkKaiStandIn lStandIn{};
+        lStandIn.SetEthernetDataCallback([&](std::string_view aData) { lRecorder.MarkReceived(aData); });
+
+        auto lConnection{std::make_shared<XLinkKaiConnection>()};
+        auto lWrapper{std::make_shared<PlaybackWrapper>(WritePlayback(lKind, lPackets), lFiles, lRecorder)};
+        auto lDevice{OpenDevice(lKind, lWrapper)};
+
+        if (!lPackets.empty() && lDevice != nullptr) {
+            lDevice->SetConnector(lConnection);
+            lConnection->SetIncomingConnection(lDevice);
+            lConnection->Open(BenchmarkHelpers_Constants::cIp, lStandIn.GetPort());
+            lConnection->StartReceiverThread();
+
+            // Playback starts with the receiver thread of the device, so only once XLink Kai is there to receive it
+            if (lStandIn.WaitForConnection(cConnectTimeout) && lDevice->StartReceiverThread()) {
+                lRecorder.WaitForReceived();
+                lRecorder.Report(aState);
+            } else {
+                aState.SkipWithError("Could not connect to the XLink Kai stand-in");
+            }
+
+            lDevice->Close();
+            lConnection->Close();
+        } else {
+            aState.SkipWithError("Could not open the device");
+        }
+    }
+}
+BENCHMARK(EndToEndDeviceToXLinkKai)
+    ->ArgsProduct({{Promiscuous, Plugin, Monitor}, {100, 10000}})
+    ->Iterations(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Packets from XLink Kai, received and sent by a device, with the device and amount of packets as arguments.
+static void EndToEndXLinkKaiToDevice(benchmark::State& aState)
+{
+    const auto         lKind{static_cast<DeviceKind>(aState.range(0))};
+    const DeviceFiles& lFiles{cDeviceFiles.at(lKind)};
+
+    for ([[maybe_unused]] auto lIterator : aState) {
+        LatencyRecorder                lRecorder{static_cast<size_t>(aState.range(1))};
+        const std::vector<std::string> lPackets{
+            lRecorder.Stamp(ReadPackets(lFiles.xlinkkai), [](std::string_view /*aPacket*/) { return true; })};
+
+        XLinkKaiStandIn lStandIn{};
+
+        auto lConnection{std::make_shared<XLinkKaiConnection>()};
+        auto lWrapper{std::make_shared<PlaybackWrapper>(WritePlayback(lKind, {}), lFiles, lRecorder)};
+        auto lDevice{OpenDevice(lKind, lWrapper)};
+
+        if (!lPackets.empty() && lDevice != nullptr) {
+            lDevice->SetConnector(lConnection);
+            lConnection->SetIncomingConnection(lDevice);
+            lConnection->Open(BenchmarkHelpers_Constants::cIp, lStandIn.GetPort());
+            lConnection->StartReceiverThread();
+
+            if (lStandIn.WaitForConnection(cConnectTimeout) && lDevice->StartReceiverThread()) {
+                // Let the device find the network in its capture first, like it would before XLink Kai sends anything
+                while (!lWrapper->IsPlayedBack()) {
+                    std::this_thread::sleep_for(milliseconds(1));
+                }
+
+                for (const auto& lPacket : lPackets) {
+                    lRecorder.MarkSent(lPacket);
+                    lStandIn.SendEthernetData(lPacket);
+                }
+
+                lRecorder.WaitForReceived();
+                lRecorder.Report(aState);
+            } else {
+                aState.SkipWithError("Could not connect to the XLink Kai stand-in");
+            }
+
+            lDevice->Close();
+            lConnection->Close();
+        } else {
+            aState.SkipWithError("Could not open the device");
+        }
+    }
+}
+BENCHMARK(EndToEndXLinkKaiToDevice)
+    ->ArgsProduct({{Promiscuous, Plugin, Monitor}, {100, 10000}})
+    ->Iterations(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
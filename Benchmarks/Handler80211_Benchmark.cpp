@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Handler80211_Benchmark.cpp
+ * This file contains benchmarks for the Handler80211 class.
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "Handler80211.h"
+
+// Cost of looking at every packet captured by a monitor device.
+static void Handler80211Update(benchmark::State& aState)
+{
+    const std::vector<std::string> lPackets{ReadPackets("MonitorHelloWorld.pcapng")};
+    Handler80211                   lHandler{PhysicalDeviceHeaderType::RadioTap};
+    size_t                         lIndex{0};
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("Could not read MonitorHelloWorld.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ShouldSend());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(Handler80211Update);
+
+// Cost of converting captured data frames to 802.3 frames for XLink Kai.
+static void Handler80211ConvertPacketOut(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{};
+    Handler80211             lHandler{PhysicalDeviceHeaderType::RadioTap};
+    size_t                   lIndex{0};
+
+    // Only data frames get converted
+    for (auto& lPacket : ReadPackets("MonitorHelloWorld.pcapng")) {
+        lHandler.Update(lPacket);
+        if (!lHandler.ConvertPacketOut().empty()) {
+            lPackets.push_back(std::move(lPacket));
+        }
+    }
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("No data frames found in MonitorHelloWorld.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ConvertPacketOut().data());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(Handler80211ConvertPacketOut);
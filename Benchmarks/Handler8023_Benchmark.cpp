@@ -0,0 +1,33 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Handler8023_Benchmark.cpp
+ * This file contains benchmarks for the Handler8023 class.
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "Handler8023.h"
+#include "NetConversionFunctions.h"
+
+// Cost of converting frames from XLink Kai to 802.11 frames for a monitor device.
+static void Handler8023ConvertPacketOut(benchmark::State& aState)
+{
+    const std::vector<std::string>                 lPackets{ReadPackets("PromiscuousHelloWorld.pcapng")};
+    const uint64_t                                 lBSSID{MacToInt("01:23:45:67:ab:cd")};
+    const RadioTapReader::PhysicalDeviceParameters lParameters{};
+    Handler8023                                    lHandler{};
+    size_t                                         lIndex{0};
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("Could not read PromiscuousHelloWorld.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ConvertPacketOut(lBSSID, lParameters).data());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(Handler8023ConvertPacketOut);
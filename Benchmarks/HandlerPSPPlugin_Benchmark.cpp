@@ -0,0 +1,53 @@
+/* Copyright (c) 2021 [Rick de Bondt] - HandlerPSPPlugin_Benchmark.cpp
+ * This file contains benchmarks for the HandlerPSPPlugin class.
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "HandlerPSPPlugin.h"
+#include "NetConversionFunctions.h"
+
+// Cost of converting frames from XLink Kai to the format the PSP plugin expects.
+static void HandlerPSPPluginConvertPacketIn(benchmark::State& aState)
+{
+    const std::vector<std::string> lPackets{ReadPackets("PluginFromXLinkTest.pcapng")};
+    const uint64_t                 lAdapterMac{MacToInt("b8:27:eb:00:00:01")};
+    HandlerPSPPlugin               lHandler{};
+    size_t                         lIndex{0};
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("Could not read PluginFromXLinkTest.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        benchmark::DoNotOptimize(lHandler.ConvertPacketIn(lPackets[lIndex], lAdapterMac).data());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(HandlerPSPPluginConvertPacketIn);
+
+// Cost of converting frames from the PSP plugin to 802.3 frames for XLink Kai.
+static void HandlerPSPPluginConvertPacketOut(benchmark::State& aState)
+{
+    const std::vector<std::string> lPackets{ReadPackets("PluginFromPSPTest.pcapng")};
+    HandlerPSPPlugin               lHandler{};
+    size_t                         lIndex{0};
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("Could not read PluginFromPSPTest.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ConvertPacketOut().data());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(HandlerPSPPluginConvertPacketOut);
@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 [Rick de Bondt] - LatencyHistogram_Benchmark.cpp
+ * This file contains benchmarks for the LatencyHistogram and LatencyStatistics classes.
+ **/
+
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "LatencyHistogram.h"
+#include "LatencyStatistics.h"
+
+// Cost of adding a single latency to a histogram.
+static void LatencyHistogramRecord(benchmark::State& aState)
+{
+    LatencyHistogram lHistogram{};
+
+    int64_t        lLatency{0};
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lHistogram.Record(std::chrono::nanoseconds(lLatency));
+        lLatency = (lLatency + 997) % 10000000;
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(LatencyHistogramRecord);
+
+// Cost of a single stage in the receive path, with recording disabled (0) and enabled (1), the clock read included.
+static void LatencyStatisticsRecord(benchmark::State& aState)
+{
+    LatencyStatistics& lStatistics{LatencyStatistics::GetInstance()};
+    lStatistics.SetEnabled(aState.range(0) != 0);
+
+    const auto     lArrival{std::chrono::system_clock::now()};
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lStatistics.Record(LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Converted, lArrival);
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+
+    lStatistics.SetEnabled(false);
+    lStatistics.Reset();
+}
+BENCHMARK(LatencyStatisticsRecord)->Arg(0)->Arg(1);
@@ -0,0 +1,54 @@
+/* Copyright (c) 2021 [Rick de Bondt] - MacBlackList_Benchmark.cpp
+ * This file contains benchmarks for the MacBlackList class.
+ **/
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "MacBlackList.h"
+
+namespace
+{
+    constexpr uint64_t cVendor{0xd44b5e000000};
+}  // namespace
+
+// Cost of the per packet check in the receive path, with the amount of blacklisted Mac addresses as argument.
+static void IsMacAllowed(benchmark::State& aState)
+{
+    MacBlackList   lBlackList{};
+    const uint64_t lAmountOfMacs{static_cast<uint64_t>(aState.range(0))};
+
+    for (uint64_t lCount = 0; lCount < lAmountOfMacs; lCount++) {
+        lBlackList.AddToMacBlackList(cVendor + lCount);
+    }
+
+    // Alternate between hits and misses, like traffic from both remote players and local devices
+    uint64_t       lMac{0};
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        benchmark::DoNotOptimize(lBlackList.IsMacAllowed(cVendor + (lMac % (lAmountOfMacs * 2))));
+        lMac++;
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(IsMacAllowed)->RangeMultiplier(4)->Range(4, 16384);
+
+// Cost of blacklisting the source of every packet coming from XLink Kai, where almost all are already known.
+static void AddToMacBlackList(benchmark::State& aState)
+{
+    MacBlackList   lBlackList{};
+    const uint64_t lAmountOfMacs{static_cast<uint64_t>(aState.range(0))};
+
+    uint64_t       lMac{0};
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lBlackList.AddToMacBlackList(cVendor + (lMac % lAmountOfMacs));
+        lMac++;
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(AddToMacBlackList)->RangeMultiplier(4)->Range(4, 16384);
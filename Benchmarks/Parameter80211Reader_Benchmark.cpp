@@ -0,0 +1,48 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Parameter80211Reader_Benchmark.cpp
+ * This file contains benchmarks for the Parameter80211Reader class.
+ **/
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "NetConversionFunctions.h"
+#include "Parameter80211Reader.h"
+
+// Cost of reading the information out of captured beacons, including finding the length of their RadioTap header.
+static void Parameter80211ReaderUpdate(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{};
+    std::vector<uint64_t>    lBSSIDs{};
+    auto                     lRadioTapReader{std::make_shared<RadioTapReader>()};
+    Parameter80211Reader     lReader{lRadioTapReader};
+    size_t                   lIndex{0};
+
+    // Only beacons carry parameters
+    for (auto& lPacket : ReadPackets("MonitorHelloWorld.pcapng")) {
+        lRadioTapReader->FillRadioTapParameters(lPacket, 0);
+        const uint16_t lLength{lRadioTapReader->GetLength()};
+        if ((lPacket.size() > static_cast<size_t>(lLength) + Net_80211_Constants::cFixedParameterTypeSSIDIndex) &&
+            (GetRawData<uint8_t>(lPacket, lLength) == Net_80211_Constants::cBeaconType)) {
+            lBSSIDs.push_back(GetRawData<uint64_t>(lPacket, lLength + Net_80211_Constants::cBSSIDIndex) &
+                              Net_Constants::cBroadcastMac);
+            lPackets.push_back(std::move(lPacket));
+        }
+    }
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("No beacons found in MonitorHelloWorld.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lRadioTapReader->FillRadioTapParameters(lPackets[lIndex], 0);
+        lReader.Update(lPackets[lIndex], lBSSIDs[lIndex]);
+        benchmark::DoNotOptimize(lReader.GetFrequency());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(Parameter80211ReaderUpdate);
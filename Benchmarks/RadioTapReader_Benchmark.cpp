@@ -0,0 +1,31 @@
+/* Copyright (c) 2021 [Rick de Bondt] - RadioTapReader_Benchmark.cpp
+ * This file contains benchmarks for the RadioTapReader class.
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "RadioTapReader.h"
+
+// Cost of decoding the RadioTap header of captured packets, with the fields to decode as argument.
+static void FillRadioTapParameters(benchmark::State& aState)
+{
+    const std::vector<std::string> lPackets{ReadPackets("MonitorHelloWorld.pcapng")};
+    const auto                     lFields{static_cast<uint32_t>(aState.range(0))};
+    RadioTapReader                 lReader{};
+    size_t                         lIndex{0};
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("Could not read MonitorHelloWorld.pcapng");
+    }
+
+    const uint64_t lAllocations{GetAllocationCount()};
+    for ([[maybe_unused]] auto lIterator : aState) {
+        lReader.FillRadioTapParameters(lPackets[lIndex], lFields);
+        benchmark::DoNotOptimize(lReader.GetFrequency());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+
+    SetPacketCounters(aState, GetAllocationCount() - lAllocations);
+}
+BENCHMARK(FillRadioTapParameters)->Arg(0)->Arg(RadioTap_Constants::cFlagsField)->Arg(RadioTap_Constants::cAllFields);
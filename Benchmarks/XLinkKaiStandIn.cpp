@@ -0,0 +1,84 @@
+/* Copyright (c) 2021 [Rick de Bondt] - XLinkKaiStandIn.cpp */
+
+#include "XLinkKaiStandIn.h"
+
+#include <array>
+#include <string>
+
+#include "XLinkKaiConnection.h"
+
+using namespace boost::asio;
+
+XLinkKaiStandIn::XLinkKaiStandIn()
+{
+    mSocket.open(ip::udp::v4());
+    mSocket.bind(ip::udp::endpoint(ip::address_v4::loopback(), 0));
+    mReceiverThread = std::make_shared<std::thread>([&] { Receive(); });
+}
+
+XLinkKaiStandIn::~XLinkKaiStandIn()
+{
+    // Wake the receiver up with an empty datagram to itself, closing the socket does not interrupt a blocking receive
+    mRunning = false;
+    boost::system::error_code lError{};
+    mSocket.send_to(buffer(std::string_view{}), mSocket.local_endpoint(), 0, lError);
+
+    mReceiverThread->join();
+    mSocket.close();
+}
+
+unsigned int XLinkKaiStandIn::GetPort() const
+{
+    return mSocket.local_endpoint().port();
+}
+
+void XLinkKaiStandIn::Receive()
+{
+    std::array<char, XLinkKai_Constants::cMaxLength> lBuffer{};
+    ip::udp::endpoint                                lSender{};
+    boost::system::error_code                        lError{};
+
+    while (mRunning) {
+        const size_t lBytesReceived{mSocket.receive_from(buffer(lBuffer), lSender, 0, lError)};
+        const std::string_view lData{lBuffer.data(), lBytesReceived};
+
+        if (!lError && mRunning) {
+            if (lData.starts_with(XLinkKai_Constants::cEthernetDataString)) {
+                if (mEthernetDataCallback) {
+                    mEthernetDataCallback(lData.substr(XLinkKai_Constants::cEthernetDataString.size()));
+                }
+            } else if (lData.starts_with(XLinkKai_Constants::cConnectString)) {
+                mRemote = lSender;
+                mSocket.send_to(buffer(XLinkKai_Constants::cConnectedString), mRemote, 0, lError);
+            } else if (lData.starts_with(XLinkKai_Constants::cKeepAliveString)) {
+                mSocket.send_to(buffer(XLinkKai_Constants::cKeepAliveString), lSender, 0, lError);
+            } else if (lData == XLinkKai_Constants::cSettingDDSOnlyString) {
+                // The settings are only sent once the connected message has been handled
+                mConnected = true;
+            }
+        }
+    }
+}
+
+void XLinkKaiStandIn::SendEthernetData(std::string_view aData)
+{
+    const std::array<const_buffer, 2> lBuffers{buffer(XLinkKai_Constants::cEthernetDataString),
+                                               buffer(aData.data(), aData.size())};
+    boost::system::error_code         lError{};
+    mSocket.send_to(lBuffers, mRemote, 0, lError);
+}
+
+void XLinkKaiStandIn::SetEthernetDataCallback(std::function<void(std::string_view)> aCallback)
+{
+    mEthernetDataCallback = std::move(aCallback);
+}
+
+bool XLinkKaiStandIn::WaitForConnection(std::chrono::milliseconds aTimeout)
+{
+    const auto lDeadline{std::chrono::steady_clock::now() + aTimeout};
+    while (!mConnected && std::chrono::steady_clock::now() < lDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return mConnected;
+}
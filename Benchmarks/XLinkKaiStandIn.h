@@ -0,0 +1,72 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - XLinkKaiStandIn.h
+ *
+ * This file contains a local stand-in for the XLink Kai engine, so the whole program can be measured without it.
+ *
+ **/
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+/**
+ * Speaks just enough of the XLink Kai protocol (connect;, connected;, keepalive; and e;e;) on a loopback UDP socket
+ * to be connected to by an XLinkKaiConnection.
+ **/
+class XLinkKaiStandIn
+{
+public:
+    /**
+     * Opens the socket on a free loopback port and starts answering on it.
+     */
+    XLinkKaiStandIn();
+    ~XLinkKaiStandIn();
+    XLinkKaiStandIn(const XLinkKaiStandIn&) = delete;
+    XLinkKaiStandIn& operator=(const XLinkKaiStandIn&) = delete;
+
+    /**
+     * Gets the port the stand-in listens on, to pass on to XLinkKaiConnection::Open.
+     * @return the port.
+     */
+    [[nodiscard]] unsigned int GetPort() const;
+
+    /**
+     * Sends ethernet data to the connected XLinkKaiConnection, as an e;e; datagram.
+     * @param aData - The ethernet frame to send.
+     */
+    void SendEthernetData(std::string_view aData);
+
+    /**
+     * Sets the function to call for every ethernet frame received from the XLinkKaiConnection. Called from the thread
+     * of the stand-in, set it before connecting.
+     * @param aCallback - The function to call with the ethernet frame.
+     */
+    void SetEthernetDataCallback(std::function<void(std::string_view)> aCallback);
+
+    /**
+     * Waits until an XLinkKaiConnection connected and sent its settings, after that ethernet data can be exchanged.
+     * @param aTimeout - How long to wait at most.
+     * @return True if connected in time.
+     */
+    bool WaitForConnection(std::chrono::milliseconds aTimeout);
+
+private:
+    /**
+     * Receives and answers datagrams until the stand-in is destroyed.
+     */
+    void Receive();
+
+    std::function<void(std::string_view)> mEthernetDataCallback{};
+    std::atomic<bool>                     mConnected{false};
+    std::atomic<bool>                     mRunning{true};
+    boost::asio::io_service               mIoService{};
+    boost::asio::ip::udp::endpoint        mRemote{};
+    boost::asio::ip::udp::socket          mSocket{mIoService};
+    std::shared_ptr<std::thread>          mReceiverThread{nullptr};
+};
@@ -18,7 +18,7 @@
 /**
  * This class reads packets from a monitor format and converts to a promiscuous format.
  **/
-class Handler80211 : public IHandler
+class Handler80211 final : public IHandler
 {
 public:
     /**
@@ -32,9 +32,9 @@ public:
     /**
      * This function converts a monitor mode packet to a promiscuous mode packet, stripping the radiotap and
      * 802.11 header and adding an 802.3 header. Only converts data packets!
-     * @return converted packet data, empty string if failed.
+     * @return converted packet data, empty if failed. Only valid until the next packet is converted.
      */
-    std::string ConvertPacketOut();
+    std::string_view ConvertPacketOut();
 
     MacBlackList& GetBlackList() override;
 
@@ -123,6 +123,7 @@ public:
     void Update(std::string_view aPacket) override;
 
 private:
+    void DecodePhysicalDeviceFlags();
     void UpdateBSSID();
     void UpdateControlPacketType();
     void UpdateDataPacketType();
@@ -133,8 +134,10 @@ private:
     void UpdateDestinationMac();
     void UpdateSourceMac();
 
-    // Save last data in this class
-    std::string mLastReceivedData{};
+    // View on the last data handled by this class, owned by the caller of Update
+    std::string_view mLastReceivedData{};
+    // Reused for every converted packet, ConvertPacketOut hands out a view on it
+    std::string      mConvertedPacket{};
 
     std::vector<std::string> mSSIDList{};
 
@@ -18,17 +18,18 @@
 /**
  * This class reads packets from a monitor format and converts to a promiscuous format.
  **/
-class Handler8023 : public IHandler
+class Handler8023 final : public IHandler
 {
 public:
     /**
      * This function converts a promiscuous mode packet to a monitor mode packet, adding the radiotap and
-     * 802.11 header and removing the 802.3 header.
+     * 802.11 header and removing the 802.3 header. The headers are built once per BSSID and parameters and reused
+     * for every packet after that.
      * @param aBSSID - BSSID to use when inserting the 80211 header.
      * @param aParameters - Parameters to use to convert to 80211.
-     * @return converted packet data, empty string if failed.
+     * @return converted packet data, empty if failed. Only valid until the next packet is converted.
      */
-    std::string ConvertPacketOut(uint64_t aBSSID, RadioTapReader::PhysicalDeviceParameters aParameters);
+    std::string_view ConvertPacketOut(uint64_t aBSSID, const RadioTapReader::PhysicalDeviceParameters& aParameters);
 
     MacBlackList& GetBlackList() override;
 
@@ -49,10 +50,25 @@ public:
     void Update(std::string_view aPacket) override;
 
 private:
-    MacBlackList mBlackList{};
-    uint16_t     mEtherType{};
-    bool         mIsBroadcastPacket{};
-    std::string  mLastReceivedData{};
-    uint64_t     mSourceMac{0};
-    uint64_t     mDestinationMac{0};
+    /**
+     * Rebuilds the RadioTap, 802.11 and LLC headers used by ConvertPacketOut, with the addresses and EtherType left
+     * empty to be filled in per packet.
+     * @param aBSSID - BSSID to use when inserting the 80211 header.
+     * @param aParameters - Parameters to use to convert to 80211.
+     */
+    void UpdateHeaderTemplate(uint64_t aBSSID, const RadioTapReader::PhysicalDeviceParameters& aParameters);
+
+    MacBlackList     mBlackList{};
+    uint16_t         mEtherType{};
+    bool             mIsBroadcastPacket{};
+    std::string_view mLastReceivedData{};
+    uint64_t         mSourceMac{0};
+    uint64_t         mDestinationMac{0};
+
+    // Reused for every converted packet, ConvertPacketOut hands out a view on it
+    std::string                              mConvertedPacket{};
+    std::string                              mHeaderTemplate{};
+    unsigned int                             mTemplateRadioTapSize{0};
+    uint64_t                                 mTemplateBSSID{0};
+    RadioTapReader::PhysicalDeviceParameters mTemplateParameters{};
 };
@@ -18,22 +18,22 @@
 /**
  * This class reads packets from a PSP plugin format and converts to a promiscuous format.
  **/
-class HandlerPSPPlugin : public IHandler
+class HandlerPSPPlugin final : public IHandler
 {
 public:
     /**
      * This function converts a PSP plugin packet to a promiscuous mode packet.
-     * @return converted packet data, empty string if failed.
+     * @return converted packet data, empty if failed. Only valid until the next packet is converted out.
      */
-    std::string ConvertPacketOut();
+    std::string_view ConvertPacketOut();
 
     /**
      * This function converts a promiscuous mode packet to a PSP plugin packet.
      * @param aData - The data to convert to a PSP plugin packet.
      * @param aAdapterMac - The mac address to put into the original destination field.
-     * @return converted packet data, empty string if failed.
+     * @return converted packet data, empty if failed. Only valid until the next packet is converted in.
      */
-    std::string ConvertPacketIn(std::string_view aData, uint64_t aAdapterMac);
+    std::string_view ConvertPacketIn(std::string_view aData, uint64_t aAdapterMac);
 
     MacBlackList& GetBlackList() override;
 
@@ -54,10 +54,14 @@ public:
     void Update(std::string_view aPacket) override;
 
 private:
-    MacBlackList mBlackList{};
-    bool         mIsBroadcastPacket{};
-    std::string  mLastReceivedData{};
-    uint64_t     mSourceMac{0};
-    uint64_t     mDestinationMac{0};
-    uint16_t     mEtherType{};
+    MacBlackList     mBlackList{};
+    bool             mIsBroadcastPacket{};
+    std::string_view mLastReceivedData{};
+    uint64_t         mSourceMac{0};
+    uint64_t         mDestinationMac{0};
+    uint16_t         mEtherType{};
+
+    // Reused for every converted packet, one per direction because both directions run on their own thread
+    std::string mConvertedPacketIn{};
+    std::string mConvertedPacketOut{};
 };
@@ -52,6 +52,7 @@ public:
 
     /**
      * Preload data about this packet into this class.
+     * @note Only a view on the packet is kept, so it has to stay valid for as long as the handler is used on it.
      * @param aData - Packet to dissect.
      */
     virtual void Update(std::string_view aPacket) = 0;
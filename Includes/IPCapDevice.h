@@ -20,11 +20,22 @@ namespace IPCapDevice_Constants
         std::string SSID{};
         uint8_t     MaxRate{RadioTap_Constants::cRateFlags};
         uint16_t    Frequency{RadioTap_Constants::cChannel};
+        bool        IsAdhoc{false};
+    };
+
+    struct CaptureStatistics
+    {
+        uint64_t Received{0};          //!< Packets that reached the capture
+        uint64_t Dropped{0};           //!< Packets dropped because the capture buffer was full
+        uint64_t InterfaceDropped{0};  //!< Packets dropped by the interface or its driver
+
+        bool operator==(const CaptureStatistics& aOther) const = default;
     };
 }  // namespace IPCapDevice_Constants
 
 class IConnector;
 class pcap_pkthdr;
+class Reactor;
 
 /**
  * Interface for pcap devices, either file based or device based.
@@ -65,6 +76,21 @@ public:
      */
     virtual std::string DataToString(const unsigned char* aData, const pcap_pkthdr* aHeader) = 0;
 
+    /**
+     * Returns a view on the data without copying it.
+     * @param aData - Data from pcap functions.
+     * @param aHeader - Header from pcap functions.
+     * @return Data as string_view, only valid as long as aData is.
+     */
+    virtual std::string_view DataToStringView(const unsigned char* aData, const pcap_pkthdr* aHeader) = 0;
+
+    /**
+     * Gets the capture statistics collected so far, these are updated periodically while receiving. Can be called
+     * from any thread.
+     * @return the amount of packets received and dropped since the device was opened.
+     */
+    virtual IPCapDevice_Constants::CaptureStatistics GetCaptureStatistics() = 0;
+
     /**
      * Gets data from last read packet.
      * @return pointer to data as an unsigned char array.
@@ -84,6 +110,26 @@ public:
      */
     virtual bool Send(std::string_view aData) = 0;
 
+    /**
+     * Queues data to be sent over the device, it will only actually be sent when Flush is called. Use this instead of
+     * Send when more packets are expected to follow, so they can be injected in one batch.
+     * @param aData - Data to queue.
+     * @return true if successful, false on failure or unsupported.
+     */
+    virtual bool Queue(std::string_view aData) = 0;
+
+    /**
+     * Sends all data that has been queued using Queue.
+     * @return true if successful, false on failure or unsupported.
+     */
+    virtual bool Flush() = 0;
+
+    /**
+     * Sets the size of the buffer the kernel captures packets into, only has effect when called before Open.
+     * @param aBufferSize - Size of the buffer in bytes, 0 to use the default of the capture backend.
+     */
+    virtual void SetCaptureBufferSize(unsigned int aBufferSize) = 0;
+
     /**
      * Sets outgoing connection.
      * @param aDevice - Device to use as the outgoing connection.
@@ -108,6 +154,13 @@ public:
      */
     virtual bool StartReceiverThread() = 0;
 
+    /**
+     * Lets the reactor drive receiving instead of a receiver thread, use this instead of StartReceiverThread.
+     * @param aReactor - Reactor to add the device to.
+     * @return true if successful, false on failure or unsupported.
+     */
+    virtual bool AddToReactor(std::shared_ptr<Reactor> aReactor) = 0;
+
     /**
      * Pcap Dispatch should be using this function to send data to.
      * @param aData The data to process.
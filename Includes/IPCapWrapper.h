@@ -6,6 +6,12 @@
  *
  **/
 
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
 /**
  * Interface for pcapwrapper.
  */
@@ -14,6 +20,7 @@ struct pcap;
 struct pcap_dumper;
 struct pcap_if;
 struct pcap_addr;
+struct pcap_stat;
 
 using pcap_t        = struct pcap;
 using pcap_dumper_t = struct pcap_dumper;
@@ -47,13 +54,20 @@ public:
     virtual void           FreeAllDevices(pcap_if_t* devices)                                     = 0;
     virtual int            GetDatalink()                                                          = 0;
     virtual char*          GetError()                                                             = 0;
+    virtual int            GetSelectableFd()                                                      = 0;
+    virtual int            GetStatistics(pcap_stat* stats)                                        = 0;
     virtual bool           IsActivated()                                                          = 0;
     virtual pcap_t*        OpenDead(int linktype, int snaplen)                                    = 0;
     virtual pcap_t*        OpenOffline(const char* fname, char* errbuf)                           = 0;
     virtual int            NextEx(pcap_pkthdr** header, const unsigned char** pkt_data)           = 0;
     virtual int            SendPacket(std::string_view buffer)                                    = 0;
+    virtual int            SendBatch(std::span<const std::string> buffers)                        = 0;
+    virtual int            SetBufferSize(int buffer_size)                                         = 0;
     virtual int            SetDirection(PcapDirection::Direction direction)                       = 0;
+    virtual int            SetFilter(std::string_view filter)                                     = 0;
     virtual int            SetImmediateMode(int mode)                                             = 0;
+    virtual int            SetNonBlock(int nonblock)                                              = 0;
+    virtual int            SetPassedSources(const std::vector<uint64_t>& sources)                 = 0;
     virtual int            SetSnapLen(int snaplen)                                                = 0;
     virtual int            SetTimeOut(int timeout)                                                = 0;
 };
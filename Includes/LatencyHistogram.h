@@ -0,0 +1,68 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - LatencyHistogram.h
+ *
+ * This file contains a lock-free histogram to record latencies in.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace LatencyHistogram_Constants
+{
+    // Every power of two gets split up in this many buckets, so a recorded value is off by at most 1/32nd (~3%)
+    constexpr unsigned int cSubBucketBits{5};
+    constexpr unsigned int cSubBucketCount{1U << cSubBucketBits};
+
+    // Values are in nanoseconds, anything from 2^40 ns (~18 minutes) on ends up in the last bucket
+    constexpr unsigned int cMaxValueBits{40};
+    constexpr unsigned int cBucketCount{(cMaxValueBits - cSubBucketBits + 1) * cSubBucketCount};
+}  // namespace LatencyHistogram_Constants
+
+/**
+ * Histogram with logarithmic buckets that are each split up linearly, the same layout HdrHistogram uses. Recording
+ * only takes a few relaxed atomic increments, so any amount of threads can record while another one reads.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * Adds a latency to the histogram, can be called from any thread.
+     * @param aLatency - The latency to add, negative latencies are counted as 0.
+     * @param aCount - How many times to add it, for a batch of packets that all took as long.
+     */
+    void Record(std::chrono::nanoseconds aLatency, uint64_t aCount = 1);
+
+    /**
+     * @return the amount of latencies recorded so far.
+     */
+    [[nodiscard]] uint64_t GetCount() const;
+
+    /**
+     * @return the highest latency recorded so far.
+     */
+    [[nodiscard]] std::chrono::nanoseconds GetMax() const;
+
+    /**
+     * Gets the latency below which the given percentage of recorded latencies fall.
+     * @param aPercentile - Percentage between 0 and 100.
+     * @return the highest latency that falls in the same bucket, 0 if nothing has been recorded.
+     */
+    [[nodiscard]] std::chrono::nanoseconds GetPercentile(double aPercentile) const;
+
+    /**
+     * Empties the histogram, latencies recorded at the same time may or may not survive this.
+     */
+    void Reset();
+
+private:
+    static unsigned int GetBucket(uint64_t aValue);
+    static uint64_t     GetHighestValueInBucket(unsigned int aBucket);
+
+    std::array<std::atomic<uint64_t>, LatencyHistogram_Constants::cBucketCount> mBuckets{};
+    std::atomic<uint64_t>                                                       mCount{0};
+    std::atomic<uint64_t>                                                       mMax{0};
+};
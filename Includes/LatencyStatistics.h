@@ -0,0 +1,150 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - LatencyStatistics.h
+ *
+ * This file contains the latency histograms for every stage a packet goes through on its way across the bridge.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "LatencyHistogram.h"
+
+struct pcap_pkthdr;
+
+namespace LatencyStatistics_Constants
+{
+    /**
+     * Which way a packet goes across the bridge.
+     */
+    enum Direction
+    {
+        ToXLinkKai = 0, /**< Captured from the device, sent to XLink Kai */
+        ToDevice        /**< Received from XLink Kai, injected on the device */
+    };
+
+    /**
+     * How far a packet got, latencies are always measured from the moment the packet arrived.
+     */
+    enum Stage
+    {
+        Converted = 0, /**< The packet handler is done with it */
+        Sent           /**< Handed to the socket or injected */
+    };
+
+    /**
+     * The kind of device that is bridging, every kind gets its own histograms so they can be compared.
+     */
+    enum ConnectionMethod
+    {
+        Monitor = 0,
+        Plugin,
+        Promiscuous
+    };
+
+    static constexpr std::array<std::string_view, 2> cDirectionTexts{"to XLink Kai", "to device"};
+    static constexpr std::array<std::string_view, 2> cStageTexts{"converted", "sent"};
+    static constexpr std::array<std::string_view, 3> cConnectionMethodTexts{"Monitor", "Plugin", "Promiscuous"};
+}  // namespace LatencyStatistics_Constants
+
+/**
+ * Keeps a LatencyHistogram per connection method, direction and stage. Recording is disabled until SetEnabled is
+ * called, after that every recorded packet costs a clock read and a few relaxed atomic increments.
+ */
+class LatencyStatistics
+{
+public:
+    LatencyStatistics(const LatencyStatistics& aLatencyStatistics) = delete;
+    LatencyStatistics& operator=(const LatencyStatistics& aLatencyStatistics) = delete;
+
+    LatencyStatistics& operator=(LatencyStatistics&& aLatencyStatistics) = delete;
+    LatencyStatistics(LatencyStatistics&& aLatencyStatistics)            = delete;
+
+    /**
+     * Gets the LatencyStatistics singleton.
+     * @return The LatencyStatistics object.
+     */
+    static LatencyStatistics& GetInstance()
+    {
+        static LatencyStatistics lInstance;
+        return lInstance;
+    }
+
+    /**
+     * Enables or disables recording, can be called from any thread.
+     * @param aEnabled - Set true to start recording.
+     */
+    void SetEnabled(bool aEnabled);
+
+    /**
+     * @return true if latencies get recorded, use this before doing anything expensive just to be able to record.
+     */
+    [[nodiscard]] bool IsEnabled() const
+    {
+        return mEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets which histograms the latencies get recorded in from now on, call this before the device starts.
+     * @param aConnectionMethod - The kind of device that is bridging.
+     */
+    void SetConnectionMethod(LatencyStatistics_Constants::ConnectionMethod aConnectionMethod);
+
+    /**
+     * Records how long ago a packet arrived, can be called from any thread.
+     * @param aDirection - Which way the packet is going.
+     * @param aStage - How far the packet got.
+     * @param aArrival - When the packet arrived, packets without an arrival time are not recorded.
+     * @param aCount - Amount of packets that arrived at the same time and got this far.
+     */
+    void Record(LatencyStatistics_Constants::Direction aDirection,
+                LatencyStatistics_Constants::Stage     aStage,
+                std::chrono::system_clock::time_point  aArrival,
+                uint64_t                               aCount = 1);
+
+    /**
+     * Records how long ago a captured packet arrived, using the timestamp the capture backend put on it.
+     * @param aDirection - Which way the packet is going.
+     * @param aStage - How far the packet got.
+     * @param aHeader - Header of the captured packet, nothing is recorded if it is nullptr.
+     */
+    void Record(LatencyStatistics_Constants::Direction aDirection,
+                LatencyStatistics_Constants::Stage     aStage,
+                const pcap_pkthdr*                     aHeader);
+
+    /**
+     * Converts the timestamp of a captured packet.
+     * @param aHeader - Header of the captured packet.
+     * @return the moment the packet was captured.
+     */
+    static std::chrono::system_clock::time_point GetArrival(const pcap_pkthdr& aHeader);
+
+    /**
+     * Empties all histograms.
+     */
+    void Reset();
+
+    /**
+     * Builds a report with the p50, p99 and p99.9 latency of every histogram that has something in it.
+     * @return the report, one line per histogram.
+     */
+    [[nodiscard]] std::string ToString() const;
+
+private:
+    LatencyStatistics() = default;
+
+    // Indexed on connection method, direction and stage
+    std::array<std::array<std::array<LatencyHistogram, LatencyStatistics_Constants::cStageTexts.size()>,
+                          LatencyStatistics_Constants::cDirectionTexts.size()>,
+               LatencyStatistics_Constants::cConnectionMethodTexts.size()>
+        mHistograms{};
+
+    std::atomic<bool>                                          mEnabled{false};
+    std::atomic<LatencyStatistics_Constants::ConnectionMethod> mConnectionMethod{
+        LatencyStatistics_Constants::ConnectionMethod::Promiscuous};
+};
@@ -8,7 +8,12 @@
  **/
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 // Does not exist in Visual Studio yet,
 // https://github.com/microsoft/STL/pull/664
@@ -19,9 +24,21 @@
 
 #include <sstream>
 #include <string>
+#include <string_view>
+
+namespace Logger_Constants
+{
+    // Amount of log messages that can be waiting for the writer thread before messages get dropped
+    constexpr size_t cRingSize{512};
+    // The ring wraps its indices with a mask
+    static_assert(cRingSize != 0 && (cRingSize & (cRingSize - 1)) == 0, "cRingSize has to be a power of two");
+    // Longer log messages get cut off, big enough for a hex dump of the largest 802.11 frame
+    constexpr size_t cMaxLength{8192};
+}  // namespace Logger_Constants
 
 /**
- * Logger class, can log text to file or stdout.
+ * Logger class, can log text to file or stdout. Messages are handed to a writer thread through a lock-free ring, so
+ * logging never blocks on I/O. Use ShouldLog before building expensive log messages.
  */
 class Logger
 {
@@ -68,23 +85,34 @@ public:
     void Init(Level aLevel, bool aLogToDisk, const std::string& aFileName);
 
     /**
-     * Logs given text to file.
+     * Logs given text to file, the text is copied so it does not have to outlive this call.
      * @param aText - Text to be logged.
      * @param aLevel - Loglevel to use.
      * @param aLocation - Source location (keep empty).
      */
 #if not defined(__APPLE__) && (defined(__GNUC__) || defined(__GNUG__))
-    void Log(const std::string&                        aText,
+    void Log(std::string_view                          aText,
              Level                                     aLevel,
              const std::experimental::source_location& aLocation = std::experimental::source_location::current());
 #else
-    void Log(const std::string& aText, Level aLevel);
+    void Log(std::string_view aText, Level aLevel);
 #endif
     /**
      * Gets the loglevel
      */
     Level GetLogLevel();
 
+    /**
+     * Checks if messages of this level would be logged, so messages that are expensive to build are not built for
+     * nothing.
+     * @param aLevel - Loglevel to check.
+     * @return true if messages of this level get logged.
+     */
+    [[nodiscard]] bool ShouldLog(Level aLevel) const
+    {
+        return aLevel >= mLogLevel.load(std::memory_order_relaxed);
+    }
+
     /**
      * Converts the loglevel to string.
      * @param aLogLevel - Log level to convert.
@@ -129,12 +157,42 @@ public:
     void SetLogToScreen(bool aLoggingToScreenEnabled);
 
 private:
-    Logger() = default;
+    /**
+     * A single log message waiting to be written.
+     */
+    struct Record
+    {
+        std::atomic<uint64_t>                          Sequence{0};
+        Level                                          LogLevel{Level::ERROR};
+        std::chrono::system_clock::time_point          Time{};
+        const char*                                    File{nullptr};
+        unsigned int                                   Line{0};
+        size_t                                         Length{0};
+        std::array<char, Logger_Constants::cMaxLength> Text{};
+    };
+
+    Logger();
     ~Logger();
 
-    std::string   mFileName{"log.txt"};
-    Level         mLogLevel{Logger::Level::ERROR};
-    std::ofstream mLogOutputStream{};
-    bool          mLogToDisk{false};
-    bool          mLogToScreen{false};
+    void Push(std::string_view aText, Level aLevel, const char* aFile, unsigned int aLine);
+    void WriteRecords();
+    void FormatRecord(const Record& aRecord);
+
+    std::string        mFileName{"log.txt"};
+    std::atomic<Level> mLogLevel{Logger::Level::ERROR};
+    std::ofstream      mLogOutputStream{};
+    std::mutex         mLogOutputMutex{};
+    std::atomic<bool>  mLogToDisk{false};
+    std::atomic<bool>  mLogToScreen{false};
+
+    // Many threads log, only the writer thread writes
+    std::unique_ptr<std::array<Record, Logger_Constants::cRingSize>> mRecords{
+        std::make_unique<std::array<Record, Logger_Constants::cRingSize>>()};
+    alignas(64) std::atomic<uint64_t> mWriteIndex{0};
+    alignas(64) std::atomic<uint32_t> mSignal{0};
+    uint64_t                          mReadIndex{0};
+    std::atomic<uint64_t>             mDropped{0};
+    std::atomic<bool>                 mRunning{true};
+    std::string                       mWriteBuffer{};
+    std::shared_ptr<std::thread>      mWriterThread{nullptr};
 };
@@ -6,23 +6,96 @@
  *
  **/
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+/**
+ * Compact open addressing hash set of Mac addresses, so lookups stay cheap no matter how many Mac addresses are in it.
+ * Mac addresses can only be added or cleared, never removed one by one, which makes lookups lock-free: any amount of
+ * threads can call Contains, Empty and Size while another thread is changing the set. Changes are serialized by a
+ * mutex.
+ */
+class MacSet
+{
+public:
+    MacSet();
+    MacSet(const MacSet& aMacSet) = delete;
+    MacSet& operator=(const MacSet& aMacSet) = delete;
+
+    /**
+     * Removes all Mac addresses from the set, keeps the memory.
+     */
+    void Clear();
+
+    /**
+     * Checks if the Mac address is in the set.
+     * @param aMac - Mac address to check.
+     * @return true if the Mac address is in the set.
+     */
+    [[nodiscard]] bool Contains(uint64_t aMac) const;
+
+    /**
+     * @return true if there are no Mac addresses in the set.
+     */
+    [[nodiscard]] bool Empty() const;
+
+    /**
+     * Gets a copy of all Mac addresses in the set, sorted. Mac addresses added while this is running may be missing.
+     * @return the Mac addresses in the set.
+     */
+    [[nodiscard]] std::vector<uint64_t> GetMacs() const;
+
+    /**
+     * Adds the Mac address to the set if it is not in there yet.
+     * @param aMac - Mac address to add.
+     * @return true if the Mac address was added, false if it was already in the set.
+     */
+    bool Insert(uint64_t aMac);
+
+    /**
+     * @return the amount of Mac addresses in the set.
+     */
+    [[nodiscard]] size_t Size() const;
+
+private:
+    struct Table
+    {
+        explicit Table(size_t aAmountOfSlots);
+
+        std::vector<std::atomic<uint64_t>> Slots;
+    };
+
+    void Grow();
+
+    std::atomic<size_t>                 mSize{0};
+    std::atomic<const Table*>           mTable{nullptr};
+    // Older tables are kept alive because readers might still be looking at them, they at most double memory usage
+    std::vector<std::unique_ptr<Table>> mTables{};
+    std::mutex                          mWriteMutex{};
+};
+
+/**
+ * Black- and whitelist of Mac addresses, can be checked from the capture thread while the XLink Kai thread adds to it.
+ */
 class MacBlackList
 {
 public:
     /**
      * Add the source Mac address to blacklist.
      * @param aMac - Mac address to blacklist.
+     * @return true if the Mac address was added, false if it was already in there or is whitelisted.
      */
-    void AddToMacBlackList(uint64_t aMac);
+    bool AddToMacBlackList(uint64_t aMac);
 
     /**
      * Add the source Mac address to whitelist. Whitelist takes prevalence over the blacklist.
      * @param aMac - Mac address to whitelist.
+     * @return true if the Mac address was added, false if it was already in there.
      */
-    void AddToMacWhiteList(uint64_t aMac);
+    bool AddToMacWhiteList(uint64_t aMac);
 
     /**
      * Clears blacklist.
@@ -34,6 +107,18 @@ public:
      */
     void ClearMacWhiteList();
 
+    /**
+     * Gets a copy of the blacklist, for example to build a capture filter from.
+     * @return the blacklisted Mac addresses, sorted.
+     */
+    [[nodiscard]] std::vector<uint64_t> GetMacBlackList() const;
+
+    /**
+     * Gets a copy of the whitelist.
+     * @return the whitelisted Mac addresses, sorted.
+     */
+    [[nodiscard]] std::vector<uint64_t> GetMacWhiteList() const;
+
     /**
      * Checks if Mac is in receiver blacklist.
      * @param aMac - Mac to check
@@ -46,19 +131,21 @@ public:
      * @param aMac - Mac to check
      * @return true if Mac address is allowed.
      */
-    bool IsMacAllowed(uint64_t aMac);
+    [[nodiscard]] bool IsMacAllowed(uint64_t aMac) const;
 
     /**
-     * Sets the source Mac addresses blacklist.
+     * Sets the source Mac addresses blacklist. Readers on other threads may see the list partially filled while this
+     * is running.
      */
     void SetMacBlackList(std::vector<uint64_t>& aBlackList);
 
     /**
-     * Sets the source Mac addresses whitelist.
+     * Sets the source Mac addresses whitelist. Readers on other threads may see the list partially filled while this
+     * is running.
      */
     void SetMacWhiteList(std::vector<uint64_t>& aWhiteList);
 
 private:
-    std::vector<uint64_t> mBlackList{};
-    std::vector<uint64_t> mWhiteList{};
+    MacSet mBlackList{};
+    MacSet mWhiteList{};
 };
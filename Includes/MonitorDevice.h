@@ -17,7 +17,7 @@
 /**
  * Class which allows a wireless device in monitor mode to capture data and send wireless frames.
  */
-class MonitorDevice : public PCapDeviceBase
+class MonitorDevice final : public PCapDeviceBase
 {
 public:
     /**
@@ -50,15 +50,25 @@ public:
 
     bool Open(std::string_view aName, std::vector<std::string>& aSSIDFilter) override;
     bool Send(std::string_view aData) override;
+    bool Queue(std::string_view aData) override;
+    bool Flush() override;
     void SetAcknowledgePackets(bool aAcknowledge);
     void SetSourceMacToFilter(uint64_t aMac);
     bool StartReceiverThread() override;
+    bool AddToReactor(std::shared_ptr<Reactor> aReactor) override;
 
 private:
+    /**
+     * Mirrors what Handler80211 drops, based on the locked onto BSSID and the black- and whitelist.
+     */
+    std::string BuildFilter() override;
+
     bool ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
 
     bool                          mAcknowledgePackets{false};
     bool                          mConnected{false};
+    // BSSID the current capture filter was built for
+    uint64_t                      mFilteredBSSID{0};
     std::string*                  mCurrentlyConnectedNetwork{nullptr};
     std::shared_ptr<IPCapWrapper> mPcapWrapper;
     Handler80211                  mPacketHandler{PhysicalDeviceHeaderType::RadioTap};
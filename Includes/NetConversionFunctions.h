@@ -145,7 +145,7 @@ static void InsertIEEE80211Header(
  * @param aParameters - Parameters to use when inserting the parameters.
  * @return size of radiotap header.
  */
-static int InsertRadioTapHeader(char* aPacket, RadioTapReader::PhysicalDeviceParameters aParameters)
+static int InsertRadioTapHeader(char* aPacket, const RadioTapReader::PhysicalDeviceParameters& aParameters)
 {
     unsigned int lIndex{sizeof(RadioTapHeader)};
 
@@ -329,6 +329,94 @@ static std::string ConstructPSPPluginHandshake(uint64_t aPSPMac, uint64_t aAdapt
     return lPacket;
 }
 
+/**
+ * Helper function for the capture filters, matches any of the given Mac addresses in a libpcap filter expression.
+ * @param aQualifier - What to match the Mac addresses against, for example "ether src" or "wlan addr2".
+ * @param aMacs - Mac addresses to match.
+ * @return the filter expression, empty if there are no Mac addresses or too many to be worth filtering on.
+ */
+static std::string ConstructMacFilter(std::string_view aQualifier, const std::vector<uint64_t>& aMacs)
+{
+    // Every Mac address costs a few instructions per packet, past this filtering in userspace is just as cheap
+    constexpr size_t cMaxFilteredMacs{64};
+
+    std::string lReturn{};
+
+    if (!aMacs.empty() && aMacs.size() <= cMaxFilteredMacs) {
+        for (uint64_t lMac : aMacs) {
+            lReturn += (lReturn.empty() ? "(" : " or ") + std::string(aQualifier) + " " + IntToMac(lMac);
+        }
+        lReturn += ")";
+    }
+
+    return lReturn;
+}
+
+/**
+ * Constructs a libpcap filter expression for an 802.3 capture, frames that don't match would be dropped after
+ * capturing anyway.
+ * @param aEtherTypes - Ethertypes to receive in the byte order they are in the frame, same as Net_Constants, empty
+ * for all of them.
+ * @param aBlackList - Source Mac addresses to drop.
+ * @return the filter expression, empty if everything should be received.
+ */
+static std::string ConstructEthernetFilter(const std::vector<uint16_t>& aEtherTypes,
+                                           const std::vector<uint64_t>& aBlackList)
+{
+    std::ostringstream lEtherTypes{};
+    for (uint16_t lEtherType : aEtherTypes) {
+        lEtherTypes << (lEtherTypes.tellp() == 0 ? "(" : " or ") << "ether proto 0x" << std::hex << std::setfill('0')
+                    << std::setw(4) << bswap_16(lEtherType);
+    }
+
+    std::string lReturn{lEtherTypes.str()};
+    if (!lReturn.empty()) {
+        lReturn += ")";
+    }
+
+    const std::string lBlackList{ConstructMacFilter("ether src", aBlackList)};
+    if (!lBlackList.empty()) {
+        lReturn += (lReturn.empty() ? "not " : " and not ") + lBlackList;
+    }
+
+    return lReturn;
+}
+
+/**
+ * Constructs a libpcap filter expression for an 802.11 capture with a physical device header in front, frames that
+ * don't match would be dropped after capturing anyway. Mirrors what Handler80211 uses: beacons to find networks,
+ * data frames on the locked onto network and acknowledgements sent to blacklisted Mac addresses.
+ * @param aLockedBSSID - BSSID to receive data frames from, 0 if not locked onto a network yet.
+ * @param aBlackList - Transmitter Mac addresses to drop.
+ * @param aWhiteList - Transmitter Mac addresses to exclusively receive from, takes prevalence over the blacklist.
+ * @return the filter expression.
+ */
+static std::string Construct80211Filter(uint64_t                     aLockedBSSID,
+                                        const std::vector<uint64_t>& aBlackList,
+                                        const std::vector<uint64_t>& aWhiteList)
+{
+    std::string lAllowed{};
+    if (!aWhiteList.empty()) {
+        lAllowed = ConstructMacFilter("wlan addr2", aWhiteList);
+    } else if (const std::string lBlackList{ConstructMacFilter("wlan addr2", aBlackList)}; !lBlackList.empty()) {
+        lAllowed = "not " + lBlackList;
+    }
+
+    std::string lReturn{"(type mgt subtype beacon" + (lAllowed.empty() ? "" : " and " + lAllowed) + ")"};
+
+    if (aLockedBSSID != 0) {
+        lReturn += " or (type data and wlan addr3 " + IntToMac(aLockedBSSID) +
+                   (lAllowed.empty() ? "" : " and " + lAllowed) + ")";
+    }
+
+    if (!aBlackList.empty()) {
+        const std::string lReceivers{ConstructMacFilter("wlan addr1", aBlackList)};
+        lReturn += " or (type ctl subtype ack" + (lReceivers.empty() ? "" : " and " + lReceivers) + ")";
+    }
+
+    return lReturn;
+}
+
 /**
  * Converts string to a pretty hex string for easy reading.
  * @param aData - Data to prettify.
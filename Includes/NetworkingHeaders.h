@@ -160,6 +160,11 @@ namespace Net_Constants
         static constexpr uint64_t cNoTargetMac{0x000000000000};
     }  // namespace Arp
 
+    namespace IPv4
+    {
+        static constexpr uint16_t cEtherType{0x0008};
+    }  // namespace IPv4
+
     static constexpr uint16_t         cPSPEtherType{0xC888};
     static constexpr uint8_t          cMacAddressLength{6};
     static constexpr uint64_t         cBroadcastMac{0xFFFFFFFFFFFF};
@@ -239,6 +244,13 @@ namespace RadioTap_Constants
     // If when receiving the radiotap header length is higher than this, assume the packet is broken.
     static constexpr uint16_t cMaxLength{64};
 
+    // Present flags of the fields RadioTapReader can decode, used to only decode the fields that are needed
+    static constexpr uint32_t cFlagsField{1U << 1U};
+    static constexpr uint32_t cRateField{1U << 2U};
+    static constexpr uint32_t cChannelField{1U << 3U};
+    static constexpr uint32_t cMCSField{1U << 19U};
+    static constexpr uint32_t cAllFields{cFlagsField | cRateField | cChannelField | cMCSField};
+
     // Note padding for these options is embedded in the different variables, so if adding a variable that's requiring
     // an alignment, make the variable a step bigger. Also do not forget to add the variable to cRadioTapSize and to
     // InsertRadioTapHeader in NetConversionFunctions.h
@@ -5,7 +5,23 @@
  * This file contains the base class for pcap devices.
  **/
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "IPCapDevice.h"
+#include "Logger.h"
+
+class IPCapWrapper;
+
+namespace PCapDeviceBase_Constants
+{
+    // How often capture statistics are collected while receiving
+    static constexpr std::chrono::seconds cStatisticsInterval{5};
+}  // namespace PCapDeviceBase_Constants
 
 /**
  * Contains the base class for pcap devices.
@@ -14,8 +30,11 @@ class PCapDeviceBase : public IPCapDevice
 {
 public:
     std::string          DataToString(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
+    std::string_view     DataToStringView(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
+    IPCapDevice_Constants::CaptureStatistics GetCaptureStatistics() override;
     const unsigned char* GetData() override;
     const pcap_pkthdr*   GetHeader() override;
+    void                 SetCaptureBufferSize(unsigned int aBufferSize) override;
     void                 SetHosting(bool aHosting) override;
     void                 SetConnector(std::shared_ptr<IConnector> aDevice) override;
     void                 ShowPacketStatistics(const pcap_pkthdr* aHeader) const override;
@@ -27,10 +46,105 @@ protected:
     void                        SetData(const unsigned char* aData);
     void                        SetHeader(const pcap_pkthdr* aHeader);
 
+    /**
+     * Adds a packet to the send queue, the buffers in the queue are reused so this normally doesn't allocate.
+     * @param aData - The packet to add.
+     */
+    void AddToSendQueue(std::string_view aData);
+
+    /**
+     * Adds a packet to the send queue and lets the caller change the queued copy in place, so changing a packet before
+     * sending it doesn't need a buffer of its own.
+     * @param aData - The packet to add.
+     * @param aModifier - Called with the queued copy while the queue is locked, keep it short.
+     */
+    template<typename Modifier> void AddToSendQueue(std::string_view aData, Modifier&& aModifier)
+    {
+        std::lock_guard<std::mutex> lLock{mSendQueueMutex};
+
+        if (mSendQueueLength == mSendQueue.size()) {
+            mSendQueue.emplace_back();
+        }
+
+        std::string& lSlot{mSendQueue.at(mSendQueueLength)};
+        lSlot.assign(aData);
+        aModifier(lSlot);
+        mSendQueueLength++;
+    }
+
+    /**
+     * Sends all packets in the send queue in one batch and empties it. The queue is swapped out first, so packets can
+     * be queued while sending.
+     * @param aWrapper - Wrapper to send the packets with.
+     * @return true if all packets were sent successfully.
+     */
+    bool FlushSendQueue(IPCapWrapper& aWrapper);
+
+    /**
+     * Builds a capture filter from the current state of the device, so the kernel can drop what would be dropped after
+     * capturing anyway.
+     * @return the filter expression, empty to receive everything.
+     */
+    virtual std::string BuildFilter();
+
+    /**
+     * Builds the list of sources whose frames should stay with the kernel stack, for capture backends that take frames
+     * away from it.
+     * @return the Mac addresses, empty if there are none.
+     */
+    virtual std::vector<uint64_t> BuildPassedSources();
+
+    /**
+     * Marks the capture filter as outdated, can be called from any thread.
+     */
+    void RequestFilterUpdate();
+
+    /**
+     * Rebuilds and installs the capture filter and the passed sources if an update was requested, should be called
+     * from the thread that receives. Packets are still filtered after capturing, so if the filter fails nothing but
+     * performance changes.
+     * @param aWrapper - Wrapper to install the filter on.
+     */
+    void UpdateFilter(IPCapWrapper& aWrapper);
+
+    /**
+     * Sets the configured capture buffer size on the wrapper, should be called before activating it.
+     * @param aWrapper - Wrapper to set the buffer size on.
+     */
+    void SetUpCaptureBuffer(IPCapWrapper& aWrapper);
+
+    /**
+     * Collects capture statistics if the last time was at least cStatisticsInterval ago, should be called from the
+     * thread that receives.
+     * @param aWrapper - Wrapper to collect the statistics from.
+     */
+    void UpdateStatistics(IPCapWrapper& aWrapper);
+
+    /**
+     * Collects capture statistics right away and logs them, warns when the kernel dropped packets since last time.
+     * @param aWrapper - Wrapper to collect the statistics from.
+     * @param aLevel - Level to log the statistics at.
+     */
+    void CollectStatistics(IPCapWrapper& aWrapper, Logger::Level aLevel);
+
 private:
     std::shared_ptr<IConnector> mConnector{nullptr};
     const unsigned char*        mData{nullptr};
     const pcap_pkthdr*          mHeader{nullptr};
     bool                        mHosting{false};
     unsigned int                mPacketCount{0};
+    // Packets can be queued from both the receiver thread and the XLink Kai thread
+    std::mutex                  mSendQueueMutex{};
+    std::vector<std::string>    mSendQueue{};
+    size_t                      mSendQueueLength{0};
+    // Held while sending, so packets leave in the order they were queued in when two threads flush at once
+    std::mutex                  mFlushMutex{};
+    std::vector<std::string>    mFlushQueue{};
+    std::atomic_bool            mFilterUpdateRequested{false};
+
+    unsigned int                          mCaptureBufferSize{0};
+    std::atomic<uint64_t>                 mReceived{0};
+    std::atomic<uint64_t>                 mDropped{0};
+    std::atomic<uint64_t>                 mInterfaceDropped{0};
+    std::chrono::steady_clock::time_point mLastStatistics{};
 };
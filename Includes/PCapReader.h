@@ -69,6 +69,8 @@ public:
     bool ReadNextData() override;
     bool Send(std::string_view aCommand, std::string_view aData) override;
     bool Send(std::string_view aData) override;
+    bool Queue(std::string_view aData) override;
+    bool Flush() override;
     void SetAcknowledgePackets(bool aAcknowledge);
     void SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice) override;
 
@@ -87,6 +89,7 @@ public:
     void SetSourceMacToFilter(uint64_t aMac);
     // In this case tries to simulate a real device
     bool StartReceiverThread() override;
+    bool AddToReactor(std::shared_ptr<Reactor> aReactor) override;
 
 private:
     bool                                                      mAcknowledgePackets{false};
@@ -100,6 +103,9 @@ private:
     bool                                                      mMonitorOutput{false};
     bool                                                      mTimeAccurate{false};
     std::shared_ptr<IHandler>                                 mPacketHandler{nullptr};
+    // Same handler as mPacketHandler but with its actual type, resolved once when opening
+    std::shared_ptr<Handler80211>                             mMonitorHandler{nullptr};
+    std::shared_ptr<Handler8023>                              mPromiscuousHandler{nullptr};
     std::shared_ptr<std::thread>                              mReplayThread{nullptr};
     std::vector<std::string>                                  mSSIDFilter{};
 };
\ No newline at end of file
@@ -7,6 +7,11 @@
  **/
 
 #include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
 
 #include <pcap/pcap.h>
 
@@ -27,16 +32,46 @@ public:
     void           FreeAllDevices(pcap_if_t* devices) override;
     int            GetDatalink() override;
     char*          GetError() override;
+    int            GetSelectableFd() override;
+    int            GetStatistics(pcap_stat* stats) override;
     bool           IsActivated() override;
     pcap_t*        OpenDead(int linktype, int snaplen) override;
     pcap_t*        OpenOffline(const char* fname, char* errbuf) override;
     int            NextEx(pcap_pkthdr** header, const unsigned char** pkt_data) override;
     int            SendPacket(std::string_view buffer) override;
+
+    /**
+     * Sends multiple packets, on Linux in a single sendmmsg call on the capture socket where possible.
+     * @param buffers - The packets to send.
+     * @return the amount of packets sent, -1 on error.
+     */
+    int            SendBatch(std::span<const std::string> buffers) override;
+    int            SetBufferSize(int buffer_size) override;
     int            SetDirection(PcapDirection::Direction direction) override;
+
+    /**
+     * Compiles a filter in the libpcap filter language and installs it, where possible libpcap hands it to the
+     * kernel so packets that don't match are never copied to us.
+     * @param filter - The filter expression, empty to receive everything.
+     * @return 0 on success, PCAP_ERROR if the filter could not be compiled or installed.
+     */
+    int            SetFilter(std::string_view filter) override;
     int            SetImmediateMode(int mode) override;
+    int            SetNonBlock(int nonblock) override;
+
+    /**
+     * Capturing doesn't take frames away from the kernel stack, so there is nothing to do.
+     * @return 0 always.
+     */
+    int            SetPassedSources(const std::vector<uint64_t>& sources) override;
     int            SetSnapLen(int snaplen) override;
     int            SetTimeOut(int timeout) override;
 
 private:
     pcap_t* mHandler{};
+#ifdef __linux__
+    // Reused between batches, so sending a batch only allocates when the batch is bigger than before
+    std::vector<mmsghdr> mBatchHeaders{};
+    std::vector<iovec>   mBatchVectors{};
+#endif
 };
@@ -0,0 +1,143 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - PacketRing.h
+ *
+ * This file contains a bounded lock-free ring of packets to hand packets from one thread to another.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+/**
+ * Bounded lock-free ring of preallocated packet slots, to hand packets from exactly one producer thread to exactly one
+ * consumer thread without allocating or locking. When the ring is full, packets are dropped and counted instead of
+ * stalling the producer.
+ * @tparam tSlots - Amount of slots in the ring, must be a power of two.
+ * @tparam tSlotSize - Maximum size of a single packet.
+ */
+template<size_t tSlots, size_t tSlotSize> class PacketRing
+{
+    static_assert((tSlots != 0) && ((tSlots & (tSlots - 1)) == 0), "Amount of slots must be a power of two");
+
+public:
+    PacketRing() = default;
+
+    /**
+     * Copies a packet into the ring, producer side only.
+     * @param aData - Packet to add, empty packets are ignored.
+     * @param aArrival - When the packet arrived, handed to the consumer along with it.
+     * @return false if the packet was not added, dropped packets (ring full or packet too big) are counted.
+     */
+    bool Push(std::string_view aData, std::chrono::system_clock::time_point aArrival = {})
+    {
+        bool lReturn{false};
+
+        const uint64_t lWriteIndex{mWriteIndex.load(std::memory_order_relaxed)};
+
+        // Empty packets would be indistinguishable from an empty ring in Front
+        if (!aData.empty()) {
+            if ((aData.size() > tSlotSize) || ((lWriteIndex - mReadIndex.load(std::memory_order_acquire)) == tSlots)) {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                Slot& lSlot{mSlots->at(lWriteIndex & (tSlots - 1))};
+                std::memcpy(lSlot.Data.data(), aData.data(), aData.size());
+                lSlot.Length  = aData.size();
+                lSlot.Arrival = aArrival;
+
+                mWriteIndex.store(lWriteIndex + 1, std::memory_order_release);
+                Signal();
+                lReturn = true;
+            }
+        }
+
+        return lReturn;
+    }
+
+    /**
+     * Gets the oldest packet in the ring without removing it, consumer side only.
+     * @return A view on the packet, empty if there is nothing in the ring. Valid until Pop is called.
+     */
+    [[nodiscard]] std::string_view Front() const
+    {
+        std::string_view lReturn{};
+
+        const uint64_t lReadIndex{mReadIndex.load(std::memory_order_relaxed)};
+
+        if (lReadIndex != mWriteIndex.load(std::memory_order_acquire)) {
+            const Slot& lSlot{mSlots->at(lReadIndex & (tSlots - 1))};
+            lReturn = std::string_view(lSlot.Data.data(), lSlot.Length);
+        }
+
+        return lReturn;
+    }
+
+    /**
+     * Gets when the oldest packet in the ring arrived, consumer side only. Only call this after Front returned a
+     * packet.
+     * @return The arrival time given to Push.
+     */
+    [[nodiscard]] std::chrono::system_clock::time_point FrontArrival() const
+    {
+        return mSlots->at(mReadIndex.load(std::memory_order_relaxed) & (tSlots - 1)).Arrival;
+    }
+
+    /**
+     * Removes the oldest packet from the ring, consumer side only. Only call this after Front returned a packet.
+     */
+    void Pop()
+    {
+        mReadIndex.store(mReadIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * Blocks the consumer until there is something in the ring, or until Signal is called.
+     */
+    void Wait()
+    {
+        const uint32_t lSignal{mSignal.load(std::memory_order_acquire)};
+
+        if (mReadIndex.load(std::memory_order_relaxed) == mWriteIndex.load(std::memory_order_acquire)) {
+            mSignal.wait(lSignal, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * Wakes up the consumer if it is waiting, for example to make it stop.
+     */
+    void Signal()
+    {
+        mSignal.fetch_add(1, std::memory_order_release);
+        mSignal.notify_one();
+    }
+
+    /**
+     * @return the amount of packets dropped since the ring was created.
+     */
+    [[nodiscard]] uint64_t GetDroppedCount() const
+    {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        std::array<char, tSlotSize>           Data{};
+        size_t                                Length{0};
+        std::chrono::system_clock::time_point Arrival{};
+    };
+
+    // Slots on the heap, the ring is usually too big for the stack
+    std::unique_ptr<std::array<Slot, tSlots>> mSlots{std::make_unique<std::array<Slot, tSlots>>()};
+
+    // Keep the indices on separate cache lines so producer and consumer don't fight over them
+    alignas(64) std::atomic<uint64_t> mWriteIndex{0};
+    alignas(64) std::atomic<uint64_t> mReadIndex{0};
+    alignas(64) std::atomic<uint32_t> mSignal{0};
+    std::atomic<uint64_t>             mDropped{0};
+};
@@ -8,9 +8,21 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "IPCapDevice.h"
 #include "RadioTapReader.h"
 
+namespace Parameter80211Reader_Constants
+{
+    // Amount of networks to remember beacon information for
+    constexpr size_t cBeaconCacheSize{32};
+}  // namespace Parameter80211Reader_Constants
+
+/**
+ * Reads parameters from 802.11 beacons. Beacons of the same network repeat about every 100ms with the same
+ * information, so the information is remembered per BSSID and only parsed again when it changes.
+ */
 class Parameter80211Reader
 {
 public:
@@ -20,11 +32,17 @@ public:
      */
     explicit Parameter80211Reader(std::shared_ptr<RadioTapReader> aPhysicalDeviceHeaderReader);
 
+    /**
+     * Gets all ad-hoc networks that sent a beacon recently.
+     * @return information about the ad-hoc networks.
+     */
+    [[nodiscard]] std::vector<IPCapDevice_Constants::WiFiBeaconInformation> GetAdhocNetworks() const;
+
     /**
      * Gets the last obtained frequency.
      * @return frequency of last updated packet, 0 if unsuccessful.
      */
-    [[nodiscard]] uint8_t GetFrequency() const;
+    [[nodiscard]] uint16_t GetFrequency() const;
 
     /**
      * Returns if network is an Adhoc network.
@@ -47,8 +65,9 @@ public:
     /**
      * Fills parameters into this object.
      * @param aData - Packet to use to update the parameters.
+     * @param aBSSID - BSSID of the network that sent the packet.
      */
-    void Update(std::string_view aData);
+    void Update(std::string_view aData, uint64_t aBSSID);
 
     /**
      * Resets the data in this object.
@@ -56,6 +75,14 @@ public:
     void Reset();
 
 private:
+    struct CachedBeacon
+    {
+        uint64_t                                     Hash{0};
+        uint64_t                                     LastSeen{0};
+        IPCapDevice_Constants::WiFiBeaconInformation Information{};
+    };
+
+    void    ParseParameters(std::string_view aData, uint16_t aIndex, unsigned int aEnd);
     uint8_t UpdateIsAdhoc(uint16_t aIndex);
     uint8_t UpdateChannelInfo(uint16_t aIndex);
     uint8_t UpdateMaxRate(uint16_t aIndex);
@@ -63,9 +90,11 @@ private:
 
     std::shared_ptr<RadioTapReader> mPhysicalDeviceHeaderReader{nullptr};
 
-    uint8_t          mFrequency{0};
-    std::string_view mLastReceivedPacket{};
-    uint8_t          mMaxRate{0};
-    bool             mIsAdhoc{false};
-    std::string      mSSID{};
+    std::vector<CachedBeacon> mBeaconCache{};
+    uint64_t                  mUpdateCount{0};
+    uint16_t                  mFrequency{0};
+    std::string_view          mLastReceivedPacket{};
+    uint8_t                   mMaxRate{0};
+    bool                      mIsAdhoc{false};
+    std::string               mSSID{};
 };
@@ -30,6 +30,8 @@ public:
         uint8_t  mKnownMCSInfo{0};
         uint8_t  mMCSFlags{0};
         uint8_t  mMCSInfo{0};
+
+        bool operator==(const PhysicalDeviceParameters& aOther) const = default;
     };
 
     /**
@@ -44,10 +46,12 @@ public:
 
     /**
      * Fills this object with information about the RadioTap header, run once per packet received where the radiotap
-     * header is of interest.
+     * header is of interest. The length and present flags are always filled in, fields that are not asked for keep
+     * their default value.
      * @param aData - The packet to use to fill the parameters.
+     * @param aFields - Fields to decode, any combination of the RadioTap_Constants field flags.
      */
-    void FillRadioTapParameters(std::string_view aData);
+    void FillRadioTapParameters(std::string_view aData, uint32_t aFields = RadioTap_Constants::cAllFields);
 
     /**
      * Get the length of the radiotap header.
@@ -113,5 +117,13 @@ public:
     [[nodiscard]] uint8_t GetMCSInfo() const;
 
 private:
+    /**
+     * Reads a single field into the parameters.
+     * @param aData - The packet to read from.
+     * @param aField - Field to read, one of the RadioTap_Constants field flags.
+     * @param aIndex - Index of the (aligned) field in the packet.
+     */
+    void ReadField(std::string_view aData, uint32_t aField, unsigned int aIndex);
+
     PhysicalDeviceParameters mParameters;
 };
@@ -0,0 +1,81 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - Reactor.h
+ *
+ * This file contains a single threaded event loop that can drive capture, XLink Kai and timers at the same time.
+ *
+ **/
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Single threaded event loop, calls callbacks when file descriptors become readable or when timers expire. Currently
+ * only supported on Linux (epoll).
+ */
+class Reactor
+{
+public:
+    using Callback = std::function<void()>;
+
+    Reactor();
+    ~Reactor();
+    Reactor(const Reactor& aReactor) = delete;
+    Reactor& operator=(const Reactor& aReactor) = delete;
+
+    /**
+     * Calls the callback every time the file descriptor becomes readable. Once started, only call this from within
+     * a callback.
+     * @param aFileDescriptor - File descriptor to watch.
+     * @param aCallback - Callback to call.
+     * @return true if successful.
+     */
+    bool AddReadable(int aFileDescriptor, Callback aCallback);
+
+    /**
+     * Stops watching a file descriptor, a callback cannot remove its own file descriptor. Once started, only call this
+     * from within a callback.
+     * @param aFileDescriptor - File descriptor to stop watching.
+     */
+    void RemoveReadable(int aFileDescriptor);
+
+    /**
+     * Calls the callback every time the interval passes. Only call this before starting.
+     * @param aInterval - Interval between calls.
+     * @param aCallback - Callback to call.
+     */
+    void AddTimer(std::chrono::milliseconds aInterval, Callback aCallback);
+
+    /**
+     * Starts running the event loop in its own thread.
+     * @return true if successful.
+     */
+    bool Start();
+
+    /**
+     * Stops the event loop and waits for the thread to finish, after this no callbacks will be called anymore.
+     */
+    void Stop();
+
+private:
+    struct Timer
+    {
+        std::chrono::milliseconds             Interval{0};
+        std::chrono::steady_clock::time_point Next{};
+        Callback                              Function{};
+    };
+
+    void Run();
+
+    int                          mEpoll{-1};
+    std::map<int, Callback>      mReadables{};
+    std::atomic<bool>            mRunning{false};
+    int                          mStopEvent{-1};
+    std::shared_ptr<std::thread> mThread{nullptr};
+    std::vector<Timer>           mTimers{};
+};
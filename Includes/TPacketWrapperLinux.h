@@ -0,0 +1,187 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - TPacketWrapperLinux.h
+ *
+ * This file contains a capture wrapper that uses memory mapped AF_PACKET rings instead of libpcap, Linux only.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <pcap/pcap.h>
+
+#include "IPCapWrapper.h"
+
+struct tpacket_block_desc;
+struct tpacket3_hdr;
+
+namespace TPacketWrapper_Constants
+{
+    // Everything that arrives in a block is handed over at once, when the block is full or when it times out
+    constexpr unsigned int              cDefaultBlockSize{128 * 1024};
+    constexpr std::chrono::milliseconds cDefaultBlockTimeOut{1};
+    constexpr unsigned int              cDefaultBlockCount{16};
+
+    // Every frame in the send ring can hold a full 802.11 frame including radiotap header
+    constexpr unsigned int cSendFrameSize{4096};
+    constexpr unsigned int cSendFramesPerBlock{16};
+    constexpr unsigned int cSendBlockCount{16};
+}  // namespace TPacketWrapper_Constants
+
+/**
+ * Capture wrapper on a TPACKET_V3 packet socket. Received frames are read straight from a ring shared with the kernel
+ * a block at a time, and injected frames are written into a second ring that is flushed with a single syscall. Kernels
+ * before 4.11 have no TPACKET_V3 send ring, there frames are sent one by one instead. There is no libpcap handle
+ * behind this wrapper, so savefiles are not supported and functions returning one return nullptr.
+ */
+class TPacketWrapper : public IPCapWrapper
+{
+public:
+    /**
+     * Constructs a wrapper, the ring is only set up on Activate.
+     * @param aBlockSize - Size of a single block in the receive ring, rounded up to whole pages.
+     * @param aBlockTimeOut - How long the kernel waits before handing over a block that isn't full yet.
+     */
+    explicit TPacketWrapper(unsigned int              aBlockSize    = TPacketWrapper_Constants::cDefaultBlockSize,
+                            std::chrono::milliseconds aBlockTimeOut = TPacketWrapper_Constants::cDefaultBlockTimeOut);
+    ~TPacketWrapper();
+    TPacketWrapper(const TPacketWrapper& aTPacketWrapper) = delete;
+    TPacketWrapper& operator=(const TPacketWrapper& aTPacketWrapper) = delete;
+
+    int            Activate() override;
+    void           BreakLoop() override;
+    void           Close() override;
+    pcap_t*        Create(const char* source, char* errbuf) override;
+    int            Dispatch(int cnt, pcap_handler callback, unsigned char* user) override;
+    void           Dump(unsigned char* user, pcap_pkthdr* header, unsigned char* message) override;
+    void           DumpClose(pcap_dumper_t* dumper) override;
+    pcap_dumper_t* DumpOpen(const char* outputfile) override;
+    int            FindAllDevices(pcap_if_t** alldevicesp, char* errbuf) override;
+    void           FreeAllDevices(pcap_if_t* devices) override;
+    int            GetDatalink() override;
+    char*          GetError() override;
+    int            GetSelectableFd() override;
+
+    /**
+     * Gets packet statistics since activation, the kernel counts every packet that reached the socket.
+     * @param stats - Gets filled with the amount of packets received and dropped because the ring was full.
+     * @return 0 on success, PCAP_ERROR if the socket is not activated or the statistics could not be read.
+     */
+    int            GetStatistics(pcap_stat* stats) override;
+    bool           IsActivated() override;
+    pcap_t*        OpenDead(int linktype, int snaplen) override;
+    pcap_t*        OpenOffline(const char* fname, char* errbuf) override;
+    int            NextEx(pcap_pkthdr** header, const unsigned char** pkt_data) override;
+    int            SendPacket(std::string_view buffer) override;
+
+    /**
+     * Sends multiple packets by filling the send ring and flushing it with a single syscall, or one by one when there
+     * is no send ring.
+     * @param buffers - The packets to send.
+     * @return the amount of packets sent, -1 on error.
+     */
+    int            SendBatch(std::span<const std::string> buffers) override;
+
+    /**
+     * Sizes the receive ring, the block size stays the same and the amount of blocks is rounded up to fit.
+     * @param buffer_size - Size of the receive ring in bytes, 0 to keep the default.
+     * @return 0 on success, PCAP_ERROR_ACTIVATED if the ring has already been set up.
+     */
+    int            SetBufferSize(int buffer_size) override;
+    int            SetDirection(PcapDirection::Direction direction) override;
+
+    /**
+     * Compiles a filter in the libpcap filter language for the datalink of the interface and attaches it to the
+     * packet socket, so packets that don't match never end up in the receive ring.
+     * @param filter - The filter expression, empty to receive everything.
+     * @return 0 on success, PCAP_ERROR if the filter could not be compiled or attached.
+     */
+    int            SetFilter(std::string_view filter) override;
+    int            SetImmediateMode(int mode) override;
+    int            SetNonBlock(int nonblock) override;
+
+    /**
+     * Capturing doesn't take frames away from the kernel stack, so there is nothing to do.
+     * @return 0 always.
+     */
+    int            SetPassedSources(const std::vector<uint64_t>& sources) override;
+    int            SetSnapLen(int snaplen) override;
+    int            SetTimeOut(int timeout) override;
+
+private:
+    /**
+     * Gets the next packet from the receive ring that matches the direction, blocks that have been read completely
+     * are handed back to the kernel on the call after, so the last packet stays valid until then.
+     * @return the packet, nullptr if nothing is ready.
+     */
+    tpacket3_hdr* NextPacket();
+
+    /**
+     * Starts reading the current block if the kernel handed it over to us.
+     * @return true if there is a block with packets to read.
+     */
+    bool OpenBlock();
+
+    /**
+     * Hands the block that is being read back to the kernel and moves on to the next one.
+     */
+    void ReleaseBlock();
+
+    /**
+     * Waits until a block is handed over, the timeout passes or BreakLoop is called.
+     */
+    void WaitForBlock();
+
+    /**
+     * Puts a packet in the send ring, it is sent on the next flush.
+     * @param aData - The packet to send.
+     * @return true if there was room for it.
+     */
+    bool QueueFrame(std::string_view aData);
+
+    /**
+     * Makes the kernel send everything that is in the send ring.
+     * @return true if successful.
+     */
+    bool FlushFrames();
+
+    void SetError(std::string_view aError);
+
+    unsigned int              mBlockSize;
+    unsigned int              mBlockCount{TPacketWrapper_Constants::cDefaultBlockCount};
+    std::chrono::milliseconds mBlockTimeOut;
+    std::string               mInterface{};
+
+    int              mSocket{-1};
+    int              mBreakEvent{-1};
+    uint8_t*         mRing{nullptr};
+    size_t           mReceiveRingSize{0};
+    size_t           mRingSize{0};
+    int              mDatalink{DLT_EN10MB};
+    std::atomic_bool mBreakLoop{false};
+
+    // Position in the receive ring
+    unsigned int        mCurrentBlock{0};
+    tpacket_block_desc* mBlock{nullptr};
+    tpacket3_hdr*       mPacket{nullptr};
+    uint32_t            mPacketsLeft{0};
+    unsigned int        mBlocksOpened{0};
+
+    // Position in the send ring, only there if the kernel supports it
+    bool         mHasSendRing{false};
+    unsigned int mCurrentFrame{0};
+
+    PcapDirection::Direction           mDirection{PcapDirection::DIR_INOUT};
+    bool                               mNonBlock{false};
+    int                                mSnapLen{UINT16_MAX};
+    int                                mTimeOut{0};
+    pcap_pkthdr                        mHeader{};
+    pcap_stat                          mStatistics{};
+    std::array<char, PCAP_ERRBUF_SIZE> mError{};
+};
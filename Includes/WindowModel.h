@@ -38,6 +38,13 @@ namespace WindowModel_Constants
         Simulation /**< Simulation device */
     };
 
+    enum CaptureBackend
+    {
+        PCap = 0, /**< libpcap, works everywhere */
+        TPacket,  /**< Memory mapped AF_PACKET rings, Linux only */
+        Xdp       /**< AF_XDP socket that only gets our frames, Linux only, promiscuous and plugin devices only */
+    };
+
     enum EngineStatus
     {
         Idle = 0,
@@ -53,6 +60,7 @@ namespace WindowModel_Constants
         "Plugin", "Promiscuous", "USB", "Simulation"};
 #endif
 
+    static constexpr std::array<std::string_view, 3> cCaptureBackendTexts{"PCap", "TPacketV3", "AF_XDP"};
     static constexpr std::array<std::string_view, 3> cEngineStatusTexts{"Idle", "Running", "Error"};
     static constexpr std::string_view                cSaveFilePath{"config.txt"};
 
@@ -60,12 +68,16 @@ namespace WindowModel_Constants
     static constexpr std::string_view cSaveAcknowledgeDataFrames{"AckDataFrames"};
     static constexpr std::string_view cSaveAutoDiscoverPSPVita{"AutoDiscoverPSPVita"};
     static constexpr std::string_view cSaveAutoDiscoverXLinkKai{"AutoDiscoverXLinkKai"};
+    static constexpr std::string_view cSaveCaptureBackend{"CaptureBackend"};
+    static constexpr std::string_view cSaveCaptureBufferSizeKiB{"CaptureBufferSizeKiB"};
     static constexpr std::string_view cSaveChannel{"Channel"};
     static constexpr std::string_view cSaveConnectionMethod{"Method"};
     static constexpr std::string_view cSaveLogLevel{"LogLevel"};
     static constexpr std::string_view cSaveOnlyAcceptFromMac{"OnlyAcceptFromMac"};
     static constexpr std::string_view cSaveReConnectionTimeOutS{"ReConnectionTimeOutS"};
     static constexpr std::string_view cSaveTheme{"Theme"};
+    static constexpr std::string_view cSaveTPacketBlockSizeKiB{"TPacketBlockSizeKiB"};
+    static constexpr std::string_view cSaveTPacketTimeOutMs{"TPacketTimeOutMs"};
     static constexpr std::string_view cSaveUseSSIDFromHost{"UseSSIDFromHost"};
     static constexpr std::string_view cSaveUseSSIDFromXLinkKai{"UseSSIDFromXLinkKai"};
     static constexpr std::string_view cSaveUseXLinkKaiHints{"UseXLinkKaiHints"};
@@ -77,12 +89,16 @@ namespace WindowModel_Constants
     static constexpr bool             cDefaultAcknowledgeDataFrames{false};
     static constexpr bool             cDefaultAutoDiscoverPSPVita{false};
     static constexpr bool             cDefaultAutoDiscoverXLinkKai{false};
+    static constexpr CaptureBackend   cDefaultCaptureBackend{CaptureBackend::PCap};
+    static constexpr std::string_view cDefaultCaptureBufferSizeKiB{"0"};  // 0 keeps the default of the backend
     static constexpr std::string_view cDefaultChannel{"1"};
     static constexpr ConnectionMethod cDefaultConnectionMethod{ConnectionMethod::Plugin};
     static constexpr Logger::Level    cDefaultLogLevel{Logger::Level::ERROR};
     static constexpr std::string_view cDefaultOnlyAcceptFromMac;
     static constexpr std::string_view cDefaultReConnectionTimeOutS{"15"};
     static constexpr std::string_view cDefaultTheme{"Default"};
+    static constexpr std::string_view cDefaultTPacketBlockSizeKiB{"128"};
+    static constexpr std::string_view cDefaultTPacketTimeOutMs{"1"};
     static constexpr bool             cDefaultUseSSIDFromHost{false};
     static constexpr bool             cDefaultUseSSIDFromXLinkKai{false};
     static constexpr bool             cDefaultUseXLinkKaiHints{false};
@@ -98,12 +114,16 @@ public:
     bool        mAcknowledgeDataFrames{WindowModel_Constants::cDefaultAcknowledgeDataFrames};
     bool        mAutoDiscoverPSPVitaNetworks{WindowModel_Constants::cDefaultAutoDiscoverPSPVita};
     bool        mAutoDiscoverXLinkKaiInstance{WindowModel_Constants::cDefaultAutoDiscoverXLinkKai};
+    WindowModel_Constants::CaptureBackend mCaptureBackend{WindowModel_Constants::cDefaultCaptureBackend};
+    std::string mCaptureBufferSizeKiB{WindowModel_Constants::cDefaultCaptureBufferSizeKiB};
     std::string mChannel{WindowModel_Constants::cDefaultChannel};
     WindowModel_Constants::ConnectionMethod mConnectionMethod{WindowModel_Constants::cDefaultConnectionMethod};
     Logger::Level                           mLogLevel{WindowModel_Constants::cDefaultLogLevel};
     std::string                             mOnlyAcceptFromMac{WindowModel_Constants::cDefaultOnlyAcceptFromMac};
     std::string                             mReConnectionTimeOutS{WindowModel_Constants::cDefaultReConnectionTimeOutS};
     std::string                             mTheme{WindowModel_Constants::cDefaultTheme};
+    std::string                             mTPacketBlockSizeKiB{WindowModel_Constants::cDefaultTPacketBlockSizeKiB};
+    std::string                             mTPacketTimeOutMs{WindowModel_Constants::cDefaultTPacketTimeOutMs};
     bool                                    mUseSSIDFromHost{WindowModel_Constants::cDefaultUseSSIDFromHost};
     bool                                    mUseSSIDFromXLinkKai{WindowModel_Constants::cDefaultUseSSIDFromXLinkKai};
     bool                                    mUseXLinkKaiHints{WindowModel_Constants::cDefaultUseXLinkKaiHints};
@@ -113,6 +133,7 @@ public:
 
     // Statuses
     WindowModel_Constants::EngineStatus mEngineStatus{WindowModel_Constants::EngineStatus::Idle};
+    std::string                         mCaptureStatistics{};
 
     // Runtime components
     std::string mCurrentlyConnectedNetwork{};
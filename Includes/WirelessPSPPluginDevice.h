@@ -35,6 +35,26 @@ public:
 
     bool Send(std::string_view aData) override;
 
+    /**
+     * Queues data to be sent on the next Flush.
+     * @param aData - Data to queue.
+     * @param aModifyData - Whether the data needs to be converted from 802.3 to a PSP plugin packet first.
+     * @return true if successful.
+     */
+    bool Queue(std::string_view aData, bool aModifyData);
+
+    bool Queue(std::string_view aData) override;
+
 private:
+    /**
+     * Only PSP plugin frames are of interest, except when they are sent by blacklisted Mac addresses.
+     */
+    std::string BuildFilter() override;
+
+    /**
+     * Blacklisted Mac addresses, which includes the adapter itself, keep their traffic on the host.
+     */
+    std::vector<uint64_t> BuildPassedSources() override;
+
     std::shared_ptr<HandlerPSPPlugin> mPacketHandler{nullptr};
 };
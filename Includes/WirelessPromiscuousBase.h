@@ -57,6 +57,8 @@ public:
 
     bool Connect(std::string_view aESSID) override;
 
+    bool Flush() override;
+
     bool Open(std::string_view aName, std::vector<std::string>& aSSIDFilter) override;
 
     /**
@@ -71,6 +73,7 @@ public:
               std::shared_ptr<IWifiInterface> aInterface);
 
     bool StartReceiverThread() override;
+    bool AddToReactor(std::shared_ptr<Reactor> aReactor) override;
 
 protected:
     uint64_t&                                           GetAdapterMacAddress();
@@ -78,6 +81,42 @@ protected:
     std::shared_ptr<IPCapWrapper>&                      GetWrapper();
 
 private:
+    /**
+     * Reconnects to another network if nothing has been received for too long and autoconnect is on.
+     */
+    void CheckReadWatchdog();
+
+    /**
+     * Starts a thread that calls CheckReadWatchdog every second if autoconnect is on. Used where the receiving loop
+     * can't do that itself: the reactor, which a reconnect would block, and the polling fallback.
+     */
+    void StartWatchdogThread();
+
+    /**
+     * Dispatches all packets pcap has ready to ReadCallback.
+     */
+    void DispatchReady();
+
+#ifdef __linux__
+    /**
+     * Creates the epoll instance ReceiveEvents waits on, watching the capture and mStopEvent.
+     * @param aSelectableFd - File descriptor from pcap that becomes readable when packets are ready.
+     * @return the epoll file descriptor, -1 if it could not be set up and polling should be used instead.
+     */
+    int SetUpEvents(int aSelectableFd);
+
+    /**
+     * Receives packets event driven, only dispatches when pcap has something ready and keeps the read watchdog going
+     * in the same loop. Runs until the device is closed.
+     * @param aEpoll - Epoll file descriptor from SetUpEvents, closed when done.
+     * @param aSelectableFd - File descriptor from pcap that becomes readable when packets are ready.
+     */
+    void ReceiveEvents(int aEpoll, int aSelectableFd);
+
+    // Used to wake up ReceiveEvents when the device is closed
+    int mStopEvent{-1};
+#endif
+
     bool                            mConnected{false};
     bool                            mSSIDFromHost{false};
     std::shared_ptr<IPCapWrapper>   mWrapper{nullptr};
@@ -32,7 +32,18 @@ public:
     bool ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
 
     bool Send(std::string_view aData) override;
+    bool Queue(std::string_view aData) override;
 
 private:
+    /**
+     * Everything is forwarded to XLink Kai, except what is sent by blacklisted Mac addresses.
+     */
+    std::string BuildFilter() override;
+
+    /**
+     * Blacklisted Mac addresses, which includes the adapter itself, keep their traffic on the host.
+     */
+    std::vector<uint64_t> BuildPassedSources() override;
+
     std::shared_ptr<Handler8023> mPacketHandler{nullptr};
 };
@@ -6,17 +6,28 @@
  *
  **/
 
+#include <array>
 #include <string>
 #include <thread>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 #include <boost/asio.hpp>
 
 #include "Handler8023.h"
 #include "IConnector.h"
+#include "PacketRing.h"
+#include "Reactor.h"
+
+class MonitorDevice;
 
 namespace XLinkKai_Constants
 {
     static constexpr int                  cMaxLength{4096};
+    static constexpr unsigned int         cReceiveBatchSize{32};
+    static constexpr unsigned int         cSendRingSize{256};
     static constexpr std::string_view     cIp{"127.0.0.1"};
     static constexpr std::string_view     cSeparator{";"};
     static constexpr std::string_view     cKeepAliveFormat{"keepalive"};
@@ -35,6 +46,9 @@ namespace XLinkKai_Constants
     static constexpr std::chrono::seconds cConnectionTimeout{10};
     static constexpr std::chrono::seconds cKeepAliveTimeout{60};
 
+    // How often the connection state is checked when running on a reactor
+    static constexpr std::chrono::milliseconds cReactorInterval{100};
+
     static const std::string cConnectString{std::string(cConnectFormat) + cSeparator.data() +
                                             cLocallyUniqueName.data() + cSeparator.data() + cEmulatorName.data() +
                                             cSeparator.data()};
@@ -99,6 +113,14 @@ public:
 
     bool StartReceiverThread() override;
 
+    /**
+     * Lets the reactor drive receiving and the connection timers instead of the receiver thread. Use this instead of
+     * StartReceiverThread.
+     * @param aReactor - Reactor to add to, Linux only.
+     * @return True if successful.
+     */
+    bool AddToReactor(std::shared_ptr<Reactor> aReactor);
+
     bool Send(std::string_view aCommand, std::string_view aData) override;
 
     bool Send(std::string_view aData) override;
@@ -131,11 +153,79 @@ public:
     void SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice) override;
 
 private:
+    /**
+     * The kinds of datagrams XLink Kai sends to us.
+     */
+    enum class Command
+    {
+        Unknown,
+        Connected,
+        Disconnected,
+        KeepAlive,
+        EthernetData,
+        EthernetDataMeta
+    };
+
+    /**
+     * Tells what kind of datagram was received by looking at its prefix, without copying anything.
+     * @param aData - The datagram, may not be empty.
+     * @return The kind of datagram.
+     */
+    static Command ClassifyCommand(std::string_view aData);
+
     /**
      * Handles traffic from XLink Kai.
      */
     void ReceiveCallback(const boost::system::error_code& aError, size_t aBytesReceived);
 
+#ifdef __linux__
+    /**
+     * Handles traffic from XLink Kai when the socket becomes readable.
+     */
+    void ReceiveBatchCallback(const boost::system::error_code& aError);
+
+    /**
+     * Drains the socket, up to cReceiveBatchSize datagrams per recvmmsg call until nothing is left.
+     */
+    void ReceiveBatch();
+#endif
+
+    /**
+     * Makes the reactor call ReceiveBatch when the socket becomes readable.
+     * @return True if successful.
+     */
+    bool AddSocketToReactor();
+
+    /**
+     * Checks the state of the connection with XLink Kai and (re)connects, times out or sends settings when needed.
+     * @return How long to wait before checking again.
+     */
+    std::chrono::milliseconds CheckConnection();
+
+    /**
+     * Reacts to a single datagram received from XLink Kai.
+     * @param aData - The datagram, only valid for the duration of this call.
+     * @param aArrival - When the datagram was received.
+     */
+    void HandleReceivedData(std::string_view aData, std::chrono::system_clock::time_point aArrival);
+
+    /**
+     * Injects everything that was queued on the incoming connection while handling received datagrams.
+     * @param aArrival - When the datagrams were received.
+     */
+    void FlushIncomingConnection(std::chrono::system_clock::time_point aArrival);
+
+    /**
+     * Gets when the packet the incoming connection is currently handling was captured.
+     * @return the capture time, empty if latencies are not being recorded.
+     */
+    std::chrono::system_clock::time_point GetCaptureArrival();
+
+    /**
+     * Starts the thread that sends the ethernet data handed to Send(aData) to XLink Kai.
+     */
+    void StartSenderThread();
+
     /**
      * Sends a keepalive back to the XLink Kai engine, call this function when a keepalive is received.
      * @return True if all bytes have been sent over successfully.
@@ -149,16 +239,38 @@ private:
     std::chrono::time_point<std::chrono::system_clock> mKeepAliveTimerStart{std::chrono::seconds{0}};
 
     std::array<char, cMaxLength> mData{};
+#ifdef __linux__
+    // Preallocated slots for batched receiving, so a burst of datagrams only costs a single syscall
+    std::array<std::array<char, cMaxLength>, cReceiveBatchSize> mBatchData{};
+    std::array<mmsghdr, cReceiveBatchSize>                      mBatchHeaders{};
+    std::array<iovec, cReceiveBatchSize>                        mBatchVectors{};
+    std::array<sockaddr_storage, cReceiveBatchSize>             mBatchAddresses{};
+#endif
     // Raw ethernet data received from XLink Kai
-    std::string                    mEthernetData{};
+    std::string_view               mEthernetData{};
     std::shared_ptr<IPCapDevice>   mIncomingConnection{nullptr};
+    // Same device as mIncomingConnection if it is a monitor device, resolved once when it is set
+    std::shared_ptr<MonitorDevice> mIncomingMonitorDevice{nullptr};
     std::string                    mIp{cIp};
     boost::asio::io_service        mIoService{};
     Handler8023                    mPacketHandler{};
+    // Packets queued on the incoming connection since it was last flushed
+    uint64_t                       mQueuedPackets{0};
     unsigned int                   mPort{cPort};
     bool                           mHosting{};
     bool                           mUseHostSSID{};
     std::shared_ptr<std::thread>   mReceiverThread{nullptr};
     boost::asio::ip::udp::endpoint mRemote{};
     boost::asio::ip::udp::socket   mSocket{mIoService};
+
+    // Ethernet data from the device waiting for the sender thread, so the capture thread never waits on the network
+    PacketRing<cSendRingSize, cMaxLength> mSendRing{};
+    std::atomic<bool>                     mSenderRunning{false};
+    // Only touched by the thread that starts and closes the connection, the capture thread checks mUseSendRing
+    std::shared_ptr<std::thread>          mSenderThread{nullptr};
+    std::atomic<bool>                     mUseSendRing{false};
+
+    // Only used when driven by a reactor instead of the receiver thread
+    std::shared_ptr<Reactor>              mReactor{nullptr};
+    std::chrono::steady_clock::time_point mNextConnectionCheck{};
 };
@@ -0,0 +1,82 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - XdpProgramLinux.h
+ *
+ * This file contains an XDP program that sends frames with specific ethertypes to an AF_XDP socket, Linux only.
+ *
+ **/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace XdpProgram_Constants
+{
+    // Amount of receive queues an interface can have sockets on
+    constexpr unsigned int cMaxQueues{64};
+    // Amount of source Mac addresses that can be handed to the kernel stack
+    constexpr unsigned int cMaxPassedSources{256};
+}  // namespace XdpProgram_Constants
+
+/**
+ * Redirects frames with one of the given ethertypes to an AF_XDP socket, everything else goes to the kernel stack
+ * untouched, as do frames from sources given to PassSources. The program is attached in generic (SKB) mode so it works
+ * on any network device, and is detached as soon as this object or the program goes away. Kept apart from the socket
+ * because the kernel BPF headers can't be mixed with libpcap.
+ */
+class XdpProgram
+{
+public:
+    XdpProgram() = default;
+    ~XdpProgram();
+    XdpProgram(const XdpProgram& aXdpProgram) = delete;
+    XdpProgram& operator=(const XdpProgram& aXdpProgram) = delete;
+
+    /**
+     * Loads the program and attaches it to the interface.
+     * @param aInterfaceIndex - Index of the interface to attach to.
+     * @param aQueueId - Receive queue the socket is bound to, frames on other queues go to the kernel stack.
+     * @param aSocket - The AF_XDP socket to redirect to.
+     * @param aEtherTypes - Ethertypes to redirect, in the byte order they are in the frame, same as Net_Constants.
+     * @return true if successful, check errno when not.
+     */
+    bool Attach(unsigned int                 aInterfaceIndex,
+                unsigned int                 aQueueId,
+                int                          aSocket,
+                const std::vector<uint16_t>& aEtherTypes);
+
+    /**
+     * Detaches the program, so the kernel stack gets everything again.
+     */
+    void Detach();
+
+    /**
+     * Hands frames from the given sources to the kernel stack instead of the socket, so traffic of the adapter itself
+     * and of everything the device filters out keeps working. Sources are only ever added, can be called before and
+     * after Attach.
+     * @param aSources - Mac addresses in the same byte order as NetConversionFunctions uses.
+     * @return true if successful, check GetError when not.
+     */
+    bool PassSources(const std::vector<uint64_t>& aSources);
+
+    /**
+     * @return a description of what went wrong in Attach or PassSources.
+     */
+    [[nodiscard]] const std::string& GetError() const;
+
+    /**
+     * @return true if the program is attached.
+     */
+    [[nodiscard]] bool IsAttached() const;
+
+private:
+    unsigned int mQueueId{0};
+    int          mMap{-1};
+    int          mPassMap{-1};
+    int          mProgram{-1};
+    int          mLink{-1};
+    std::string  mError{};
+
+    // Kept so they can be put in the pass map again when attaching after a detach
+    std::vector<uint64_t> mPassedSources{};
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+/* Copyright (c) 2021 [Rick de Bondt] - XdpWrapperLinux.h
+ *
+ * This file contains a capture wrapper that receives only the frames we care about through an AF_XDP socket, Linux
+ * only.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <pcap/pcap.h>
+
+#include "IPCapWrapper.h"
+#include "XdpProgramLinux.h"
+
+namespace XdpWrapper_Constants
+{
+    // Shared memory (UMEM) between us and the kernel, the first half of the frames is used for receiving
+    constexpr unsigned int cFrameSize{2048};
+    constexpr unsigned int cFrameCount{4096};
+    constexpr unsigned int cRingSize{cFrameCount / 2};
+
+    // Only one socket is bound, on the first queue, frames from other queues go to the kernel stack like before
+    constexpr unsigned int cQueueId{0};
+
+    // How long to keep trying when the queue is still busy from a socket that was just closed
+    constexpr unsigned int              cBindRetries{50};
+    constexpr std::chrono::milliseconds cBindRetryInterval{10};
+
+    // How often the kernel gets kicked when it is not done sending yet
+    constexpr unsigned int cMaxKicks{1024};
+}  // namespace XdpWrapper_Constants
+
+/**
+ * Capture wrapper on an AF_XDP socket. An XdpProgram redirects frames with one of the given ethertypes to the socket,
+ * everything else, and everything from the sources given to SetPassedSources, goes to the kernel stack untouched. Only
+ * incoming Ethernet frames can be captured this way, so this is meant for the promiscuous and plugin devices. There is
+ * no libpcap handle behind this wrapper, so savefiles are not supported and functions returning one return nullptr.
+ */
+class XdpWrapper : public IPCapWrapper
+{
+public:
+    /**
+     * Constructs a wrapper, the socket and XDP program are only set up on Activate.
+     * @param aEtherTypes - Ethertypes to receive, in the byte order they are in the frame, same as Net_Constants.
+     */
+    explicit XdpWrapper(std::vector<uint16_t> aEtherTypes);
+    ~XdpWrapper();
+    XdpWrapper(const XdpWrapper& aXdpWrapper) = delete;
+    XdpWrapper& operator=(const XdpWrapper& aXdpWrapper) = delete;
+
+    int            Activate() override;
+    void           BreakLoop() override;
+    void           Close() override;
+    pcap_t*        Create(const char* source, char* errbuf) override;
+    int            Dispatch(int cnt, pcap_handler callback, unsigned char* user) override;
+    void           Dump(unsigned char* user, pcap_pkthdr* header, unsigned char* message) override;
+    void           DumpClose(pcap_dumper_t* dumper) override;
+    pcap_dumper_t* DumpOpen(const char* outputfile) override;
+    int            FindAllDevices(pcap_if_t** alldevicesp, char* errbuf) override;
+    void           FreeAllDevices(pcap_if_t* devices) override;
+    int            GetDatalink() override;
+    char*          GetError() override;
+    int            GetSelectableFd() override;
+
+    /**
+     * Gets packet statistics since activation, only counting frames the XDP program redirected to us.
+     * @param stats - Gets filled with the amount of frames received and dropped because a ring was full or empty.
+     * @return 0 on success, PCAP_ERROR if the socket is not activated or the statistics could not be read.
+     */
+    int            GetStatistics(pcap_stat* stats) override;
+    bool           IsActivated() override;
+    pcap_t*        OpenDead(int linktype, int snaplen) override;
+    pcap_t*        OpenOffline(const char* fname, char* errbuf) override;
+    int            NextEx(pcap_pkthdr** header, const unsigned char** pkt_data) override;
+    int            SendPacket(std::string_view buffer) override;
+
+    /**
+     * Sends multiple packets by putting all of them on the transmit ring before kicking the kernel.
+     * @param buffers - The packets to send.
+     * @return the amount of packets sent, -1 on error.
+     */
+    int            SendBatch(std::span<const std::string> buffers) override;
+
+    /**
+     * The shared memory with the kernel has a fixed size, see XdpWrapper_Constants.
+     * @return PCAP_ERROR always.
+     */
+    int            SetBufferSize(int buffer_size) override;
+    int            SetDirection(PcapDirection::Direction direction) override;
+
+    /**
+     * Socket filters don't apply to AF_XDP sockets, the XDP program already only redirects the given ethertypes.
+     * @return PCAP_ERROR always.
+     */
+    int            SetFilter(std::string_view filter) override;
+    int            SetImmediateMode(int mode) override;
+    int            SetNonBlock(int nonblock) override;
+
+    /**
+     * Hands frames from the given sources to the kernel stack instead of the socket, so the traffic of the adapter
+     * itself is never taken away from it. Sources are only ever added, up to XdpProgram_Constants::cMaxPassedSources.
+     * @param sources - Mac addresses in the same byte order as NetConversionFunctions uses.
+     * @return 0 on success, PCAP_ERROR if the sources could not be handed to the XDP program.
+     */
+    int            SetPassedSources(const std::vector<uint64_t>& sources) override;
+    int            SetSnapLen(int snaplen) override;
+    int            SetTimeOut(int timeout) override;
+
+private:
+    /**
+     * A ring shared with the kernel, we own one side of it and the kernel the other.
+     */
+    struct Ring
+    {
+        uint32_t* Producer{nullptr};
+        uint32_t* Consumer{nullptr};
+        uint8_t*  Descriptors{nullptr};
+        void*     Map{nullptr};
+        size_t    MapSize{0};
+        uint32_t  Cached{0};  //!< Our own producer or consumer index
+    };
+
+    /**
+     * Registers the UMEM and sets up and maps all four rings.
+     * @return true if successful.
+     */
+    bool SetUpRings();
+
+    /**
+     * Hands frames that have been read back to the kernel through the fill ring.
+     */
+    void ReleaseFrames();
+
+    /**
+     * Waits until something is received, the timeout passes or BreakLoop is called.
+     */
+    void WaitForFrames();
+
+    /**
+     * Takes back transmit frames the kernel is done with.
+     */
+    void ReclaimFrames();
+
+    /**
+     * Puts a packet on the transmit ring, it is sent on the next flush.
+     * @param aData - The packet to send, should fit in a frame.
+     * @return true if there was room for it.
+     */
+    bool QueueFrame(std::string_view aData);
+
+    /**
+     * Makes the kernel send everything that is on the transmit ring.
+     * @return true if successful.
+     */
+    bool FlushFrames();
+
+    void SetError(std::string_view aError);
+
+    std::vector<uint16_t> mEtherTypes;
+    std::string           mInterface{};
+
+    XdpProgram       mProgram{};
+    int              mSocket{-1};
+    int              mBreakEvent{-1};
+    uint8_t*         mUmem{nullptr};
+    std::atomic_bool mBreakLoop{false};
+
+    Ring mFillRing{};
+    Ring mCompletionRing{};
+    Ring mReceiveRing{};
+    Ring mTransmitRing{};
+
+    // Received frames that have been handed out but not given back to the kernel yet
+    uint32_t              mPending{0};
+    uint64_t              mReceived{0};
+    std::vector<uint64_t> mFreeFrames{};
+
+    bool                               mNonBlock{false};
+    int                                mSnapLen{UINT16_MAX};
+    int                                mTimeOut{0};
+    pcap_pkthdr                        mHeader{};
+    std::array<char, PCAP_ERRBUF_SIZE> mError{};
+};
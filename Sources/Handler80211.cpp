@@ -14,9 +14,10 @@ Handler80211::Handler80211(PhysicalDeviceHeaderType aType)
     mParameter80211Reader = std::make_shared<Parameter80211Reader>(mPhysicalDeviceHeaderReader);
 }
 
-std::string Handler80211::ConvertPacketOut()
+std::string_view Handler80211::ConvertPacketOut()
 {
-    std::string lConvertedPacket{};
+    // The buffer keeps its capacity, so after the first few packets no allocations are needed anymore
+    mConvertedPacket.clear();
 
     // Only important if Data type
     if ((mPhysicalDeviceHeaderReader != nullptr) && (mMainPacketType == Main80211PacketType::Data)) {
@@ -50,19 +51,19 @@ std::string Handler80211::ConvertPacketOut()
                 if (mLastReceivedData.size() >
                     Net_80211_Constants::cDataHeaderLength + mPhysicalDeviceHeaderReader->GetLength()) {
                     // Strip framecheck sequence as well.
-                    lConvertedPacket.reserve(mLastReceivedData.size() - Net_80211_Constants::cDataIndex -
+                    mConvertedPacket.reserve(mLastReceivedData.size() - Net_80211_Constants::cDataIndex -
                                              mPhysicalDeviceHeaderReader->GetLength() - lFCSLength);
 
-                    lConvertedPacket.append(mLastReceivedData.substr(lDestinationAddressIndex,
+                    mConvertedPacket.append(mLastReceivedData.substr(lDestinationAddressIndex,
                                                                      Net_80211_Constants::cDestinationAddressLength));
 
-                    lConvertedPacket.append(
+                    mConvertedPacket.append(
                         mLastReceivedData.substr(lSourceAddressIndex, Net_80211_Constants::cSourceAddressLength));
 
-                    lConvertedPacket.append(
+                    mConvertedPacket.append(
                         mLastReceivedData.substr(lTypeIndex, Net_80211_Constants::cEtherTypeLength));
 
-                    lConvertedPacket.append(
+                    mConvertedPacket.append(
                         mLastReceivedData.substr(lDataIndex, mLastReceivedData.size() - lDataIndex - lFCSLength));
                 } else {
                     Logger::GetInstance().Log("The header has an invalid length, cannot convert the packet",
@@ -74,7 +75,7 @@ std::string Handler80211::ConvertPacketOut()
     }
 
     // [ Destination Mac | Source Mac | EtherType ] [ Payload ]
-    return lConvertedPacket;
+    return mConvertedPacket;
 }
 
 MacBlackList& Handler80211::GetBlackList()
@@ -168,6 +169,8 @@ bool Handler80211::IsDropped() const
 void Handler80211::SavePhysicalDeviceParameters(RadioTapReader::PhysicalDeviceParameters& aParameters)
 {
     if (mPhysicalDeviceHeaderReader != nullptr) {
+        // Update only decoded what was needed to decide what to do with the packet, now decode everything at once
+        mPhysicalDeviceHeaderReader->FillRadioTapParameters(mLastReceivedData, RadioTap_Constants::cAllFields);
         aParameters = mPhysicalDeviceHeaderReader->ExportRadioTapParameters();
     }
 }
@@ -193,8 +196,10 @@ void Handler80211::Update(std::string_view aPacket)
     mEtherType         = 0;
     mIsBroadcastPacket = false;
 
+    // Decoding happens in stages, cheapest checks first, so the many packets we don't care about cost next to nothing.
+    // At first only the length of the physical device header is needed to find the 802.11 header.
     if (mPhysicalDeviceHeaderReader != nullptr) {
-        mPhysicalDeviceHeaderReader->FillRadioTapParameters(aPacket);
+        mPhysicalDeviceHeaderReader->FillRadioTapParameters(aPacket, 0);
     }
 
     UpdateMainPacketType();
@@ -216,50 +221,59 @@ void Handler80211::Update(std::string_view aPacket)
             break;
         case Main80211PacketType::Data:
             // Only do something with the data frame if we care about this network
-            UpdateSourceMac();
             UpdateBSSID();
-            if (GetBlackList().IsMacAllowed(mSourceMac) && IsBSSIDAllowed(mBSSID)) {
-                UpdateDestinationMac();
-
-                // Put above ackable because ackable needs this flag to be up-to-date
-                mIsBroadcastPacket = mDestinationMac == Net_Constants::cBroadcastMac;
-
-                UpdateAckable();
-                UpdateDataPacketType();
-                UpdateRetry();
-
-                mEtherType = GetRawData<uint16_t>(mLastReceivedData, Net_8023_Constants::cEtherTypeIndex);
-
-                // Only save parameters on normal data types.
-                if (!mRetry) {
-                    switch (mDataPacketType) {
-                        case Data80211PacketType::Data:
-                            Logger::GetInstance().Log("Saving parameters for a Data packet type", Logger::Level::TRACE);
-                            SavePhysicalDeviceParameters(mPhysicalDeviceParametersData);
-                            mShouldSend = true;
-                            break;
-                        case Data80211PacketType::QoSData:
-                            mShouldSend = true;
-                            break;
-                        default:
-                            break;
+            if (IsBSSIDAllowed(mBSSID)) {
+                UpdateSourceMac();
+
+                if (GetBlackList().IsMacAllowed(mSourceMac)) {
+                    UpdateDestinationMac();
+
+                    // Put above ackable because ackable needs this flag to be up-to-date
+                    mIsBroadcastPacket = mDestinationMac == Net_Constants::cBroadcastMac;
+
+                    UpdateAckable();
+                    UpdateDataPacketType();
+                    UpdateRetry();
+
+                    mEtherType = GetRawData<uint16_t>(mLastReceivedData, Net_8023_Constants::cEtherTypeIndex);
+
+                    // Only save parameters on normal data types. Flags are needed to strip the FCS when converting,
+                    // saving the parameters decodes them along with the rest.
+                    if (!mRetry) {
+                        switch (mDataPacketType) {
+                            case Data80211PacketType::Data:
+                                Logger::GetInstance().Log("Saving parameters for a Data packet type",
+                                                          Logger::Level::TRACE);
+                                SavePhysicalDeviceParameters(mPhysicalDeviceParametersData);
+                                mShouldSend = true;
+                                break;
+                            case Data80211PacketType::QoSData:
+                                DecodePhysicalDeviceFlags();
+                                mShouldSend = true;
+                                break;
+                            default:
+                                DecodePhysicalDeviceFlags();
+                                break;
+                        }
+                        mIsDropped = false;
+                    } else {
+                        Logger::GetInstance().Log("Packet Retry blocked", Logger::Level::TRACE);
                     }
-                    mIsDropped = false;
-                } else {
-                    Logger::GetInstance().Log("Packet Retry blocked", Logger::Level::TRACE);
                 }
             }
             break;
         case Main80211PacketType::Management:
-            UpdateSourceMac();
+            UpdateManagementPacketType();
 
-            if (GetBlackList().IsMacAllowed(mSourceMac)) {
-                UpdateManagementPacketType();
+            if (mManagementPacketType == Management80211PacketType::Beacon) {
+                UpdateSourceMac();
 
-                if (mManagementPacketType == Management80211PacketType::Beacon) {
-                    mParameter80211Reader->Update(mLastReceivedData);
+                if (GetBlackList().IsMacAllowed(mSourceMac)) {
+                    // Flags are needed to find the end of the information elements
+                    DecodePhysicalDeviceFlags();
+                    UpdateBSSID();
+                    mParameter80211Reader->Update(mLastReceivedData, mBSSID);
                     if (IsSSIDAllowed(mParameter80211Reader->GetSSID())) {
-                        UpdateBSSID();
                         if (mBSSID != mLockedBSSID) {
                             mLockedBSSID = mBSSID;
                             mLockedSSID  = mParameter80211Reader->GetSSID().data();
@@ -279,6 +293,13 @@ void Handler80211::Update(std::string_view aPacket)
     }
 }
 
+void Handler80211::DecodePhysicalDeviceFlags()
+{
+    if (mPhysicalDeviceHeaderReader != nullptr) {
+        mPhysicalDeviceHeaderReader->FillRadioTapParameters(mLastReceivedData, RadioTap_Constants::cFlagsField);
+    }
+}
+
 void Handler80211::UpdateAckable()
 {
     // TODO: Filter multicast
@@ -314,7 +335,7 @@ void Handler80211::UpdateControlPacketType()
             lResult = Control80211PacketType::BlockAck;
         } else if ((lControlType & 0b1111U) == 0b1101U) {
             lResult = Control80211PacketType::ACK;
-        } else {
+        } else if (Logger::GetInstance().ShouldLog(Logger::Level::DEBUG)) {
             Logger::GetInstance().Log("Could not determine control packet type: " + std::to_string(lControlType),
                                       Logger::Level::DEBUG);
         }
@@ -340,7 +361,7 @@ void Handler80211::UpdateDataPacketType()
             lResult = Data80211PacketType::QoSData;
         } else if ((lDataType & 0b1111U) == 0b1100U) {
             lResult = Data80211PacketType::QoSNull;
-        } else {
+        } else if (Logger::GetInstance().ShouldLog(Logger::Level::DEBUG)) {
             Logger::GetInstance().Log("Could not determine data packet type: " + std::to_string(lDataType),
                                       Logger::Level::DEBUG);
         }
@@ -403,7 +424,7 @@ void Handler80211::UpdateManagementPacketType()
             lResult = Management80211PacketType::Action;
         } else if ((lManagementType & 0b1111U) == 0b1110U) {
             lResult = Management80211PacketType::ActionNoAck;
-        } else {
+        } else if (Logger::GetInstance().ShouldLog(Logger::Level::DEBUG)) {
             Logger::GetInstance().Log("Could not determine management packet type: " + std::to_string(lManagementType),
                                       Logger::Level::DEBUG);
         }
@@ -2,58 +2,73 @@
 
 #include "Handler8023.h"
 
+#include <cstddef>
+
 #include "Logger.h"
 #include "NetConversionFunctions.h"
 
-std::string Handler8023::ConvertPacketOut(uint64_t aBSSID, RadioTapReader::PhysicalDeviceParameters aParameters)
+std::string_view Handler8023::ConvertPacketOut(uint64_t                                        aBSSID,
+                                               const RadioTapReader::PhysicalDeviceParameters& aParameters)
 {
-    std::string lReturn;
-    if (mLastReceivedData.size() > Net_8023_Constants::cHeaderLength) {
-        unsigned int lIeee80211HeaderSize{sizeof(ieee80211_hdr)};
-        unsigned int lLLCHeaderSize{sizeof(uint64_t)};
-        unsigned int lDataSize{
-            static_cast<unsigned int>(mLastReceivedData.size() - (Net_8023_Constants::cHeaderLength * sizeof(char)))};
-
-        unsigned int lReserveSize{lIeee80211HeaderSize + lLLCHeaderSize + lDataSize};
-
-        std::vector<char> lFullPacket;
-        lFullPacket.reserve(lReserveSize);
-        lFullPacket.resize(lReserveSize);
-
-        unsigned int lIndex{0};
+    mConvertedPacket.clear();
 
-        // RadioTap Header
-        int lRadioTapSize = InsertRadioTapHeader(&lFullPacket[0], aParameters);
-        lIndex += lRadioTapSize;
+    if (mLastReceivedData.size() > Net_8023_Constants::cHeaderLength) {
+        if (mHeaderTemplate.empty() || (aBSSID != mTemplateBSSID) || !(aParameters == mTemplateParameters)) {
+            UpdateHeaderTemplate(aBSSID, aParameters);
+        }
 
-        lFullPacket.reserve(lReserveSize + lRadioTapSize);
-        lFullPacket.resize(lReserveSize + lRadioTapSize);
+        // Data, without header included
+        std::string_view lData{mLastReceivedData.substr(Net_8023_Constants::cHeaderLength)};
+
+        mConvertedPacket.reserve(mHeaderTemplate.size() + lData.size());
+        mConvertedPacket.append(mHeaderTemplate);
+        mConvertedPacket.append(lData);
+
+        // For Ad-Hoc
+        //  | Address 1   | Address 2   | Address 3   | Address 4 |
+        //  +-------------+-------------+-------------+-----------+
+        //  | Destination | Source      | BSSID       | N/A       |
+        char* lIeee80211Header{mConvertedPacket.data() + mTemplateRadioTapSize};
+        memcpy(lIeee80211Header + offsetof(ieee80211_hdr, addr1),
+               &mDestinationMac,
+               Net_80211_Constants::cDestinationAddressLength * sizeof(uint8_t));
+        memcpy(lIeee80211Header + offsetof(ieee80211_hdr, addr2),
+               &mSourceMac,
+               Net_80211_Constants::cSourceAddressLength * sizeof(uint8_t));
+
+        // Set EtherType from ethernet frame, it is the last part of the Logical Link Control (LLC) header
+        memcpy(lIeee80211Header + sizeof(ieee80211_hdr) + sizeof(uint64_t) - sizeof(mEtherType),
+               &mEtherType,
+               sizeof(mEtherType));
+    } else {
+        Logger::GetInstance().Log("The header has an invalid length, cannot convert the packet",
+                                  Logger::Level::WARNING);
+    }
 
-        // IEEE80211 Header
-        InsertIEEE80211Header(&lFullPacket[0], mSourceMac, mDestinationMac, aBSSID, lIndex);
-        lIndex += lIeee80211HeaderSize;
+    return mConvertedPacket;
+}
 
-        // Logical Link Control (LLC) header
-        uint64_t lLLC = Net_80211_Constants::cSnapLLC;
+void Handler8023::UpdateHeaderTemplate(uint64_t aBSSID, const RadioTapReader::PhysicalDeviceParameters& aParameters)
+{
+    unsigned int lIeee80211HeaderSize{sizeof(ieee80211_hdr)};
+    unsigned int lLLCHeaderSize{sizeof(uint64_t)};
 
-        // Set EtherType from ethernet frame
-        lLLC |= static_cast<uint64_t>(mEtherType) << 48LLU;
+    // Big enough for the RadioTap header including MCS information, shrunk to the real size afterwards
+    mHeaderTemplate.assign(RadioTap_Constants::cRadioTapSize + 3 + lIeee80211HeaderSize + lLLCHeaderSize, '\0');
 
-        memcpy(&lFullPacket[0] + lIndex, &lLLC, sizeof(lLLC));
-        lIndex += lLLCHeaderSize;
+    // RadioTap Header
+    mTemplateRadioTapSize = InsertRadioTapHeader(mHeaderTemplate.data(), aParameters);
+    mHeaderTemplate.resize(mTemplateRadioTapSize + lIeee80211HeaderSize + lLLCHeaderSize);
 
-        // Data, without header included
-        memcpy(&lFullPacket[0] + lIndex,
-               mLastReceivedData.data() + (Net_8023_Constants::cHeaderLength * (sizeof(char))),
-               mLastReceivedData.size() - (Net_8023_Constants::cHeaderLength * (sizeof(char))));
+    // IEEE80211 Header, addresses get filled in per packet
+    InsertIEEE80211Header(mHeaderTemplate.data(), 0, 0, aBSSID, mTemplateRadioTapSize);
 
-        lReturn = std::string(lFullPacket.begin(), lFullPacket.end());
-    } else {
-        Logger::GetInstance().Log("The header has an invalid length, cannot convert the packet",
-                                  Logger::Level::WARNING);
-    }
+    // Logical Link Control (LLC) header, EtherType gets filled in per packet
+    uint64_t lLLC = Net_80211_Constants::cSnapLLC;
+    memcpy(mHeaderTemplate.data() + mTemplateRadioTapSize + lIeee80211HeaderSize, &lLLC, sizeof(lLLC));
 
-    return lReturn;
+    mTemplateBSSID      = aBSSID;
+    mTemplateParameters = aParameters;
 }
 
 MacBlackList& Handler8023::GetBlackList()
@@ -7,33 +7,43 @@
 #include "Logger.h"
 #include "NetConversionFunctions.h"
 
-std::string HandlerPSPPlugin::ConvertPacketOut()
+std::string_view HandlerPSPPlugin::ConvertPacketOut()
 {
-    std::string lReturn{mLastReceivedData.data(), mLastReceivedData.size()};
-
-    // With the plugin the destination mac is kept at the end of the packet
-    memcpy(lReturn.data() + Net_8023_Constants::cDestinationAddressIndex,
-           &mDestinationMac,
-           Net_8023_Constants::cDestinationAddressLength);
-
-    lReturn.resize(lReturn.size() - Net_8023_Constants::cDestinationAddressLength);
+    mConvertedPacketOut.clear();
+
+    if (mLastReceivedData.size() >= Net_8023_Constants::cHeaderLength + Net_8023_Constants::cDestinationAddressLength) {
+        // With the plugin the destination mac is kept at the end of the packet, leave it off
+        mConvertedPacketOut.append(
+            mLastReceivedData.substr(0, mLastReceivedData.size() - Net_8023_Constants::cDestinationAddressLength));
+
+        memcpy(mConvertedPacketOut.data() + Net_8023_Constants::cDestinationAddressIndex,
+               &mDestinationMac,
+               Net_8023_Constants::cDestinationAddressLength);
+    } else {
+        Logger::GetInstance().Log("The packet is too short, cannot convert the packet", Logger::Level::WARNING);
+    }
 
-    return lReturn;
+    return mConvertedPacketOut;
 }
 
-std::string HandlerPSPPlugin::ConvertPacketIn(std::string_view aData, uint64_t aAdapterMac)
+std::string_view HandlerPSPPlugin::ConvertPacketIn(std::string_view aData, uint64_t aAdapterMac)
 {
-    std::string lData{aData.data(), aData.size()};
-
-    std::string lActualSourceMac{
-        lData.substr(Net_8023_Constants::cSourceAddressIndex, Net_8023_Constants::cSourceAddressLength)};
-
-    memcpy(
-        lData.data() + Net_8023_Constants::cSourceAddressIndex, &aAdapterMac, Net_8023_Constants::cSourceAddressLength);
-
-    lData.append(lActualSourceMac);
+    mConvertedPacketIn.clear();
+
+    if (aData.size() >= Net_8023_Constants::cHeaderLength) {
+        // The actual source mac is moved to the end of the packet, the adapter mac takes its place
+        mConvertedPacketIn.append(aData);
+        mConvertedPacketIn.append(
+            aData.substr(Net_8023_Constants::cSourceAddressIndex, Net_8023_Constants::cSourceAddressLength));
+
+        memcpy(mConvertedPacketIn.data() + Net_8023_Constants::cSourceAddressIndex,
+               &aAdapterMac,
+               Net_8023_Constants::cSourceAddressLength);
+    } else {
+        Logger::GetInstance().Log("The packet is too short, cannot convert the packet", Logger::Level::WARNING);
+    }
 
-    return lData;
+    return mConvertedPacketIn;
 }
 
 MacBlackList& HandlerPSPPlugin::GetBlackList()
@@ -0,0 +1,98 @@
+/* Copyright (c) 2021 [Rick de Bondt] - LatencyHistogram.cpp */
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace LatencyHistogram_Constants;
+
+unsigned int LatencyHistogram::GetBucket(uint64_t aValue)
+{
+    unsigned int lReturn{static_cast<unsigned int>(aValue)};
+
+    if (aValue >= (1ULL << cMaxValueBits)) {
+        lReturn = cBucketCount - 1;
+    } else if (aValue >= cSubBucketCount) {
+        // Keep the top cSubBucketBits + 1 bits, the shift tells the power of two and those bits where in it we are
+        const unsigned int lShift{static_cast<unsigned int>(std::bit_width(aValue)) - cSubBucketBits - 1};
+        lReturn = (lShift * cSubBucketCount) + static_cast<unsigned int>(aValue >> lShift);
+    }
+
+    return lReturn;
+}
+
+uint64_t LatencyHistogram::GetHighestValueInBucket(unsigned int aBucket)
+{
+    uint64_t lReturn{aBucket};
+
+    if (aBucket >= cSubBucketCount) {
+        const unsigned int lShift{(aBucket / cSubBucketCount) - 1};
+        lReturn = ((static_cast<uint64_t>((aBucket % cSubBucketCount) + cSubBucketCount + 1)) << lShift) - 1;
+    }
+
+    return lReturn;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds aLatency, uint64_t aCount)
+{
+    const uint64_t lValue{static_cast<uint64_t>(std::max<int64_t>(aLatency.count(), 0))};
+
+    mBuckets.at(GetBucket(lValue)).fetch_add(aCount, std::memory_order_relaxed);
+    mCount.fetch_add(aCount, std::memory_order_relaxed);
+
+    uint64_t lMax{mMax.load(std::memory_order_relaxed)};
+    while (lValue > lMax && !mMax.compare_exchange_weak(lMax, lValue, std::memory_order_relaxed)) {
+        // lMax got updated, try again
+    }
+}
+
+uint64_t LatencyHistogram::GetCount() const
+{
+    return mCount.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetMax() const
+{
+    return std::chrono::nanoseconds(mMax.load(std::memory_order_relaxed));
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetPercentile(double aPercentile) const
+{
+    uint64_t lReturn{0};
+
+    // Other threads may still be recording, so count what is actually in the buckets right now
+    uint64_t lTotal{0};
+    for (const auto& lBucket : mBuckets) {
+        lTotal += lBucket.load(std::memory_order_relaxed);
+    }
+
+    if (lTotal > 0) {
+        const double   lFraction{std::clamp(aPercentile, 0.0, 100.0) / 100.0};
+        const uint64_t lTarget{
+            std::max<uint64_t>(static_cast<uint64_t>(std::ceil(lFraction * static_cast<double>(lTotal))), 1)};
+
+        uint64_t     lSeen{0};
+        unsigned int lBucket{0};
+        while (lBucket < cBucketCount && lSeen < lTarget) {
+            lSeen += mBuckets.at(lBucket).load(std::memory_order_relaxed);
+            lBucket++;
+        }
+
+        // Never report more than what was actually recorded
+        lReturn = std::min(GetHighestValueInBucket(lBucket - 1), mMax.load(std::memory_order_relaxed));
+    }
+
+    return std::chrono::nanoseconds(lReturn);
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto& lBucket : mBuckets) {
+        lBucket.store(0, std::memory_order_relaxed);
+    }
+
+    mCount.store(0, std::memory_order_relaxed);
+    mMax.store(0, std::memory_order_relaxed);
+}
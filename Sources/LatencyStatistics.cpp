@@ -0,0 +1,96 @@
+/* Copyright (c) 2021 [Rick de Bondt] - LatencyStatistics.cpp */
+
+#include "LatencyStatistics.h"
+
+#include <cstdio>
+
+#include <pcap/pcap.h>
+
+using namespace LatencyStatistics_Constants;
+
+namespace
+{
+    constexpr std::array<double, 3> cPercentiles{50.0, 99.0, 99.9};
+
+    std::string FormatLatency(std::chrono::nanoseconds aLatency)
+    {
+        std::array<char, 32> lBuffer{};
+        std::snprintf(lBuffer.data(), lBuffer.size(), "%.1fus", static_cast<double>(aLatency.count()) / 1000.0);
+        return lBuffer.data();
+    }
+}  // namespace
+
+void LatencyStatistics::SetEnabled(bool aEnabled)
+{
+    mEnabled.store(aEnabled, std::memory_order_relaxed);
+}
+
+void LatencyStatistics::SetConnectionMethod(ConnectionMethod aConnectionMethod)
+{
+    mConnectionMethod.store(aConnectionMethod, std::memory_order_relaxed);
+}
+
+void LatencyStatistics::Record(Direction                             aDirection,
+                               Stage                                 aStage,
+                               std::chrono::system_clock::time_point aArrival,
+                               uint64_t                              aCount)
+{
+    if (IsEnabled() && aArrival != std::chrono::system_clock::time_point{} && aCount > 0) {
+        mHistograms.at(mConnectionMethod.load(std::memory_order_relaxed))
+            .at(aDirection)
+            .at(aStage)
+            .Record(std::chrono::system_clock::now() - aArrival, aCount);
+    }
+}
+
+void LatencyStatistics::Record(Direction aDirection, Stage aStage, const pcap_pkthdr* aHeader)
+{
+    if (IsEnabled() && aHeader != nullptr) {
+        Record(aDirection, aStage, GetArrival(*aHeader));
+    }
+}
+
+std::chrono::system_clock::time_point LatencyStatistics::GetArrival(const pcap_pkthdr& aHeader)
+{
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(aHeader.ts.tv_sec) +
+                                                                        std::chrono::microseconds(aHeader.ts.tv_usec)));
+}
+
+void LatencyStatistics::Reset()
+{
+    for (auto& lDirections : mHistograms) {
+        for (auto& lStages : lDirections) {
+            for (auto& lHistogram : lStages) {
+                lHistogram.Reset();
+            }
+        }
+    }
+}
+
+std::string LatencyStatistics::ToString() const
+{
+    std::string lReturn{"Latency since arrival (p50 / p99 / p99.9 / max):\n"};
+
+    for (size_t lMethod = 0; lMethod < mHistograms.size(); lMethod++) {
+        for (size_t lDirection = 0; lDirection < mHistograms.at(lMethod).size(); lDirection++) {
+            for (size_t lStage = 0; lStage < mHistograms.at(lMethod).at(lDirection).size(); lStage++) {
+                const LatencyHistogram& lHistogram{mHistograms.at(lMethod).at(lDirection).at(lStage)};
+
+                if (lHistogram.GetCount() > 0) {
+                    lReturn += std::string(cConnectionMethodTexts.at(lMethod)) + " " +
+                               cDirectionTexts.at(lDirection).data() + ", " + cStageTexts.at(lStage).data() + ": ";
+
+                    for (double lPercentile : cPercentiles) {
+                        lReturn += FormatLatency(lHistogram.GetPercentile(lPercentile)) + " / ";
+                    }
+
+                    lReturn += FormatLatency(lHistogram.GetMax()) + " over " +
+                               std::to_string(lHistogram.GetCount()) + " packets\n";
+                }
+            }
+        }
+    }
+
+    return lReturn;
+}
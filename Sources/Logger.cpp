@@ -2,15 +2,35 @@
 
 #include "Logger.h"
 
-#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
 #include <iostream>
 
 #include "WindowModel.h"
 
+using namespace Logger_Constants;
+
+Logger::Logger()
+{
+    // Every record starts out free for the producer that gets its index
+    for (uint64_t lCount = 0; lCount < cRingSize; lCount++) {
+        mRecords->at(lCount).Sequence.store(lCount, std::memory_order_relaxed);
+    }
+
+    mWriteBuffer.reserve(cMaxLength * 4);
+    mWriterThread = std::make_shared<std::thread>([&] { WriteRecords(); });
+}
+
 Logger::~Logger()
 {
+    // The writer thread writes everything that is left before stopping
+    mRunning = false;
+    mSignal.fetch_add(1, std::memory_order_release);
+    mSignal.notify_one();
+    mWriterThread->join();
+
     if (mLogOutputStream.is_open()) {
         mLogOutputStream.close();
     }
@@ -30,7 +50,7 @@ void Logger::SetFileName(const std::string& aFileName)
 
 Logger::Level Logger::GetLogLevel()
 {
-    return mLogLevel;
+    return mLogLevel.load(std::memory_order_relaxed);
 }
 
 std::string Logger::ConvertLogLevelToString(Logger::Level aLogLevel)
@@ -40,7 +60,7 @@ std::string Logger::ConvertLogLevelToString(Logger::Level aLogLevel)
 
 void Logger::SetLogLevel(Level aLevel)
 {
-    mLogLevel = aLevel;
+    mLogLevel.store(aLevel, std::memory_order_relaxed);
 }
 
 Logger::Level Logger::ConvertLogLevelStringToLevel(std::string_view aLevel)
@@ -58,6 +78,8 @@ Logger::Level Logger::ConvertLogLevelStringToLevel(std::string_view aLevel)
 
 void Logger::SetLogToDisk(bool aLoggingToDiskEnabled)
 {
+    std::lock_guard<std::mutex> lLock{mLogOutputMutex};
+
     if (aLoggingToDiskEnabled && !mLogOutputStream.is_open() && !mFileName.empty()) {
         mLogOutputStream.open(mFileName);
         if (mLogOutputStream.fail()) {
@@ -76,34 +98,129 @@ void Logger::SetLogToScreen(bool aLoggingToScreenEnabled)
 }
 
 #if not defined(__APPLE__) && (defined(__GNUC__) || defined(__GNUG__))
-void Logger::Log(const std::string& aText, Level aLevel, const std::experimental::source_location& aLocation)
+void Logger::Log(std::string_view aText, Level aLevel, const std::experimental::source_location& aLocation)
+{
+    if (ShouldLog(aLevel)) {
+        Push(aText, aLevel, aLocation.file_name(), aLocation.line());
+    }
+}
 #else
-void Logger::Log(const std::string& aText, Level aLevel)
+void Logger::Log(std::string_view aText, Level aLevel)
+{
+    if (ShouldLog(aLevel)) {
+        Push(aText, aLevel, nullptr, 0);
+    }
+}
 #endif
+
+void Logger::Push(std::string_view aText, Level aLevel, const char* aFile, unsigned int aLine)
 {
-    std::stringstream lLogEntry;
+    // Claim a record, a record is free when its sequence number matches the index (bounded MPSC queue)
+    Record*  lRecord{nullptr};
+    bool     lFull{false};
+    uint64_t lIndex{mWriteIndex.load(std::memory_order_relaxed)};
+    while (lRecord == nullptr && !lFull) {
+        Record&       lCandidate{mRecords->at(lIndex & (cRingSize - 1))};
+        const int64_t lDifference{
+            static_cast<int64_t>(lCandidate.Sequence.load(std::memory_order_acquire) - lIndex)};
+
+        if (lDifference == 0) {
+            if (mWriteIndex.compare_exchange_weak(lIndex, lIndex + 1, std::memory_order_relaxed)) {
+                lRecord = &lCandidate;
+            }
+        } else if (lDifference < 0) {
+            // The writer thread can't keep up, rather lose a message than block the caller
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            lFull = true;
+        } else {
+            lIndex = mWriteIndex.load(std::memory_order_relaxed);
+        }
+    }
 
-    if (aLevel >= mLogLevel) {
-        auto lTime        = std::chrono::system_clock::now();
-        auto lTimeAsTimeT = std::chrono::system_clock::to_time_t(lTime);
-        auto lTimeMs      = std::chrono::duration_cast<std::chrono::milliseconds>(lTime.time_since_epoch()) % 1000;
+    if (lRecord != nullptr) {
+        lRecord->LogLevel = aLevel;
+        lRecord->Time     = std::chrono::system_clock::now();
+        lRecord->File     = aFile;
+        lRecord->Line     = aLine;
+        lRecord->Length   = std::min(aText.size(), cMaxLength);
+        std::memcpy(lRecord->Text.data(), aText.data(), lRecord->Length);
+
+        lRecord->Sequence.store(lIndex + 1, std::memory_order_release);
+        mSignal.fetch_add(1, std::memory_order_release);
+        mSignal.notify_one();
+    }
+}
 
-#if not defined(__APPLE__) && (defined(__GNUC__) || defined(__GNUG__))
-        lLogEntry << std::put_time(std::gmtime(&lTimeAsTimeT), "%H:%M:%S:") << std::setfill('0') << std::setw(3)
-                  << lTimeMs.count() << ": " << cLevelTexts.at(static_cast<unsigned long>(aLevel)) << ": "
-                  << aLocation.file_name() << ":" << aLocation.line() << ":" << aText;
-#else
-        lLogEntry << std::put_time(std::gmtime(&lTimeAsTimeT), "%H:%M:%S:") << std::setfill('0') << std::setw(3)
-                  << lTimeMs.count() << ": " << cLevelTexts.at(static_cast<unsigned long>(aLevel)) << ":" << aText;
-#endif
+void Logger::FormatRecord(const Record& aRecord)
+{
+    auto lTimeAsTimeT = std::chrono::system_clock::to_time_t(aRecord.Time);
+    auto lTimeMs      = std::chrono::duration_cast<std::chrono::milliseconds>(aRecord.Time.time_since_epoch()) % 1000;
+
+    const std::tm* lTime{std::gmtime(&lTimeAsTimeT)};
+
+    std::array<char, 64> lPrefix{};
+    const int            lPrefixLength{std::snprintf(lPrefix.data(),
+                                                     lPrefix.size(),
+                                                     "%02d:%02d:%02d:%03d: ",
+                                                     lTime->tm_hour,
+                                                     lTime->tm_min,
+                                                     lTime->tm_sec,
+                                                     static_cast<int>(lTimeMs.count()))};
+
+    mWriteBuffer.append(lPrefix.data(), static_cast<size_t>(std::max(lPrefixLength, 0)));
+    mWriteBuffer.append(cLevelTexts.at(static_cast<unsigned long>(aRecord.LogLevel)));
+    if (aRecord.File != nullptr) {
+        mWriteBuffer.append(": ");
+        mWriteBuffer.append(aRecord.File);
+        mWriteBuffer.append(":");
+        mWriteBuffer.append(std::to_string(aRecord.Line));
+    }
+    mWriteBuffer.append(":");
+    mWriteBuffer.append(aRecord.Text.data(), aRecord.Length);
+    mWriteBuffer.append("\n");
+}
+
+void Logger::WriteRecords()
+{
+    bool     lRunning{true};
+    uint64_t lReportedDropped{0};
+
+    while (lRunning) {
+        const uint32_t lSignal{mSignal.load(std::memory_order_acquire)};
+        // Read this before draining, so nothing logged before stopping gets lost
+        lRunning = mRunning.load(std::memory_order_acquire);
+
+        // Gather everything that is ready, so it can be written in one go
+        mWriteBuffer.clear();
+        Record* lRecord{&mRecords->at(mReadIndex & (cRingSize - 1))};
+        while (lRecord->Sequence.load(std::memory_order_acquire) == mReadIndex + 1) {
+            FormatRecord(*lRecord);
+            lRecord->Sequence.store(mReadIndex + cRingSize, std::memory_order_release);
+            mReadIndex++;
+            lRecord = &mRecords->at(mReadIndex & (cRingSize - 1));
+        }
 
-        if (mLogToScreen) {
-            std::cout << lLogEntry.str() << std::endl;
+        const uint64_t lDropped{mDropped.load(std::memory_order_relaxed)};
+        if (lDropped != lReportedDropped) {
+            mWriteBuffer.append("Logger could not keep up, log messages dropped: " +
+                                std::to_string(lDropped - lReportedDropped) + "\n");
+            lReportedDropped = lDropped;
         }
 
-        // Save message to log file
-        if (mLogToDisk && mLogOutputStream.is_open()) {
-            mLogOutputStream << lLogEntry.str() << std::endl;
+        if (!mWriteBuffer.empty()) {
+            if (mLogToScreen) {
+                std::cout.write(mWriteBuffer.data(), static_cast<std::streamsize>(mWriteBuffer.size()));
+                std::cout.flush();
+            }
+
+            // Save messages to log file
+            std::lock_guard<std::mutex> lLock{mLogOutputMutex};
+            if (mLogToDisk && mLogOutputStream.is_open()) {
+                mLogOutputStream.write(mWriteBuffer.data(), static_cast<std::streamsize>(mWriteBuffer.size()));
+                mLogOutputStream.flush();
+            }
+        } else if (lRunning) {
+            mSignal.wait(lSignal, std::memory_order_acquire);
         }
     }
 }
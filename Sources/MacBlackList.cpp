@@ -2,67 +2,225 @@
 
 #include "MacBlackList.h"
 
+#include <algorithm>
+
 #include "Logger.h"
 #include "NetConversionFunctions.h"
 
-void MacBlackList::AddToMacBlackList(uint64_t aMac)
+namespace
 {
-    if (IsMacAllowed(aMac)) {
-        Logger::GetInstance().Log("Added: " + IntToMac(aMac) + " to blacklist.", Logger::Level::TRACE);
-        mBlackList.push_back(aMac);
+    // Mac addresses are only 48 bits, so this can never be a real one
+    constexpr uint64_t cEmptySlot{UINT64_MAX};
+    constexpr size_t   cMinimumSlots{16};
+
+    size_t Hash(uint64_t aMac, size_t aAmountOfSlots)
+    {
+        // Fibonacci hashing spreads the mostly sequential vendor parts of Mac addresses over the table, the amount of
+        // slots is always a power of two.
+        return static_cast<size_t>((aMac * 0x9e3779b97f4a7c15ULL) >> 32U) & (aAmountOfSlots - 1);
+    }
+}  // namespace
+
+MacSet::Table::Table(size_t aAmountOfSlots) : Slots(aAmountOfSlots)
+{
+    for (auto& lSlot : Slots) {
+        lSlot.store(cEmptySlot, std::memory_order_relaxed);
     }
 }
 
-void MacBlackList::AddToMacWhiteList(uint64_t aMac)
+MacSet::MacSet()
 {
-    Logger::GetInstance().Log("Added: " + IntToMac(aMac) + " to whitelist.", Logger::Level::TRACE);
-    mWhiteList.push_back(aMac);
+    mTables.push_back(std::make_unique<Table>(cMinimumSlots));
+    mTable.store(mTables.back().get(), std::memory_order_release);
 }
 
-void MacBlackList::ClearMacBlackList()
+void MacSet::Clear()
 {
-    mBlackList.clear();
+    std::lock_guard<std::mutex> lLock{mWriteMutex};
+
+    // Readers that are probing at the same time see the set shrink, which is fine
+    for (auto& lSlot : mTables.back()->Slots) {
+        lSlot.store(cEmptySlot, std::memory_order_relaxed);
+    }
+    mSize.store(0, std::memory_order_release);
 }
 
-void MacBlackList::ClearMacWhiteList()
+bool MacSet::Contains(uint64_t aMac) const
 {
-    mWhiteList.clear();
+    bool lReturn{false};
+
+    const Table& lTable{*mTable.load(std::memory_order_acquire)};
+    const size_t lAmountOfSlots{lTable.Slots.size()};
+    size_t       lSlot{Hash(aMac, lAmountOfSlots)};
+
+    // The load factor is at most one half, so there is always an empty slot to end on
+    uint64_t lValue{lTable.Slots[lSlot].load(std::memory_order_acquire)};
+    while (lValue != cEmptySlot && lValue != aMac) {
+        lSlot  = (lSlot + 1) & (lAmountOfSlots - 1);
+        lValue = lTable.Slots[lSlot].load(std::memory_order_acquire);
+    }
+
+    if (lValue == aMac) {
+        lReturn = true;
+    }
+
+    return lReturn;
 }
 
-bool MacBlackList::IsMacAllowed(uint64_t aMac)
+bool MacSet::Empty() const
+{
+    return Size() == 0;
+}
+
+std::vector<uint64_t> MacSet::GetMacs() const
+{
+    std::vector<uint64_t> lReturn{};
+
+    const Table& lTable{*mTable.load(std::memory_order_acquire)};
+    lReturn.reserve(Size());
+
+    for (const auto& lSlot : lTable.Slots) {
+        const uint64_t lMac{lSlot.load(std::memory_order_acquire)};
+        if (lMac != cEmptySlot) {
+            lReturn.push_back(lMac);
+        }
+    }
+
+    // Slot order depends on the hash, sorting makes the result the same no matter how the set was filled
+    std::sort(lReturn.begin(), lReturn.end());
+
+    return lReturn;
+}
+
+bool MacSet::Insert(uint64_t aMac)
 {
     bool lReturn{false};
 
-    if (mWhiteList.empty()) {
-        if (std::find(mBlackList.begin(), mBlackList.end(), aMac) == mBlackList.end()) {
-            lReturn = true;
+    std::lock_guard<std::mutex> lLock{mWriteMutex};
+
+    if (!Contains(aMac)) {
+        // Keep the load factor at or below one half so probe sequences stay short
+        if ((mSize.load(std::memory_order_relaxed) + 1) * 2 > mTables.back()->Slots.size()) {
+            Grow();
         }
-    } else {
-        if (std::find(mWhiteList.begin(), mWhiteList.end(), aMac) != mWhiteList.end()) {
-            lReturn = true;
+
+        Table&       lTable{*mTables.back()};
+        const size_t lAmountOfSlots{lTable.Slots.size()};
+        size_t       lSlot{Hash(aMac, lAmountOfSlots)};
+
+        while (lTable.Slots[lSlot].load(std::memory_order_relaxed) != cEmptySlot) {
+            lSlot = (lSlot + 1) & (lAmountOfSlots - 1);
         }
+
+        lTable.Slots[lSlot].store(aMac, std::memory_order_release);
+        mSize.fetch_add(1, std::memory_order_release);
+        lReturn = true;
     }
 
     return lReturn;
 }
 
-bool MacBlackList::IsMacBlackListed(uint64_t aMac) const
+size_t MacSet::Size() const
+{
+    return mSize.load(std::memory_order_acquire);
+}
+
+void MacSet::Grow()
+{
+    const Table& lOldTable{*mTables.back()};
+    auto         lNewTable{std::make_unique<Table>(lOldTable.Slots.size() * 2)};
+    const size_t lAmountOfSlots{lNewTable->Slots.size()};
+
+    for (const auto& lOldSlot : lOldTable.Slots) {
+        const uint64_t lMac{lOldSlot.load(std::memory_order_relaxed)};
+        if (lMac != cEmptySlot) {
+            size_t lSlot{Hash(lMac, lAmountOfSlots)};
+            while (lNewTable->Slots[lSlot].load(std::memory_order_relaxed) != cEmptySlot) {
+                lSlot = (lSlot + 1) & (lAmountOfSlots - 1);
+            }
+            lNewTable->Slots[lSlot].store(lMac, std::memory_order_relaxed);
+        }
+    }
+
+    // Publishing the new table makes everything in it visible to readers at once
+    mTable.store(lNewTable.get(), std::memory_order_release);
+    mTables.push_back(std::move(lNewTable));
+}
+
+bool MacBlackList::AddToMacBlackList(uint64_t aMac)
+{
+    bool lReturn{false};
+
+    if (IsMacAllowed(aMac) && mBlackList.Insert(aMac)) {
+        Logger::GetInstance().Log("Added: " + IntToMac(aMac) + " to blacklist.", Logger::Level::TRACE);
+        lReturn = true;
+    }
+
+    return lReturn;
+}
+
+bool MacBlackList::AddToMacWhiteList(uint64_t aMac)
 {
     bool lReturn{false};
 
-    if (std::find(mBlackList.begin(), mBlackList.end(), aMac) != mBlackList.end()) {
+    if (mWhiteList.Insert(aMac)) {
+        Logger::GetInstance().Log("Added: " + IntToMac(aMac) + " to whitelist.", Logger::Level::TRACE);
         lReturn = true;
     }
 
     return lReturn;
 }
 
+void MacBlackList::ClearMacBlackList()
+{
+    mBlackList.Clear();
+}
+
+void MacBlackList::ClearMacWhiteList()
+{
+    mWhiteList.Clear();
+}
+
+std::vector<uint64_t> MacBlackList::GetMacBlackList() const
+{
+    return mBlackList.GetMacs();
+}
+
+std::vector<uint64_t> MacBlackList::GetMacWhiteList() const
+{
+    return mWhiteList.GetMacs();
+}
+
+bool MacBlackList::IsMacAllowed(uint64_t aMac) const
+{
+    bool lReturn{false};
+
+    if (mWhiteList.Empty()) {
+        lReturn = !mBlackList.Contains(aMac);
+    } else {
+        lReturn = mWhiteList.Contains(aMac);
+    }
+
+    return lReturn;
+}
+
+bool MacBlackList::IsMacBlackListed(uint64_t aMac) const
+{
+    return mBlackList.Contains(aMac);
+}
+
 void MacBlackList::SetMacBlackList(std::vector<uint64_t>& aBlackList)
 {
-    mBlackList = std::move(aBlackList);
+    mBlackList.Clear();
+    for (uint64_t lMac : aBlackList) {
+        mBlackList.Insert(lMac);
+    }
 }
 
 void MacBlackList::SetMacWhiteList(std::vector<uint64_t>& aWhiteList)
 {
-    mWhiteList = std::move(aWhiteList);
-}
\ No newline at end of file
+    mWhiteList.Clear();
+    for (uint64_t lMac : aWhiteList) {
+        mWhiteList.Insert(lMac);
+    }
+}
@@ -7,7 +7,9 @@
 #include <string>
 #include <thread>
 
+#include "LatencyStatistics.h"
 #include "NetConversionFunctions.h"
+#include "Reactor.h"
 #include "XLinkKaiConnection.h"
 namespace
 {
@@ -51,11 +53,14 @@ bool MonitorDevice::Open(std::string_view aName, std::vector<std::string>& aSSID
     mPcapWrapper->SetSnapLen(cSnapshotLength);
     mPcapWrapper->SetTimeOut(cTimeout);
     mPcapWrapper->SetImmediateMode(1);
+    SetUpCaptureBuffer(*mPcapWrapper);
 
     int lStatus{mPcapWrapper->Activate()};
 
     if (lStatus == 0) {
         mConnected = true;
+        RequestFilterUpdate();
+        UpdateFilter(*mPcapWrapper);
     } else {
         lReturn = false;
         Logger::GetInstance().Log("pcap_activate failed, " + std::string(pcap_statustostr(lStatus)),
@@ -66,7 +71,19 @@ bool MonitorDevice::Open(std::string_view aName, std::vector<std::string>& aSSID
 
 void MonitorDevice::BlackList(uint64_t aMac)
 {
-    mPacketHandler.GetBlackList().AddToMacBlackList(aMac);
+    // XLink Kai hands over the source of every packet it sends, only rebuild the filter for new ones
+    if (mPacketHandler.GetBlackList().AddToMacBlackList(aMac)) {
+        RequestFilterUpdate();
+    }
+}
+
+std::string MonitorDevice::BuildFilter()
+{
+    mFilteredBSSID = mPacketHandler.GetLockedBSSID();
+
+    return Construct80211Filter(mFilteredBSSID,
+                                mPacketHandler.GetBlackList().GetMacBlackList(),
+                                mPacketHandler.GetBlackList().GetMacWhiteList());
 }
 
 void MonitorDevice::Close()
@@ -79,6 +96,7 @@ void MonitorDevice::Close()
         mReceiverThread->join();
     }
 
+    CollectStatistics(*mPcapWrapper, Logger::Level::INFO);
     mPcapWrapper->Close();
 
     SetData(nullptr);
@@ -92,13 +110,20 @@ bool MonitorDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr*
     bool lReturn{false};
 
     // Load all needed information into the handler
-    std::string lData{DataToString(aData, aHeader)};
+    std::string_view lData{DataToStringView(aData, aHeader)};
 
     mPacketHandler.Update(lData);
 
+    // Data frames from a newly found network are dropped by the kernel until the filter is rebuilt
+    if (mPacketHandler.GetLockedBSSID() != mFilteredBSSID) {
+        RequestFilterUpdate();
+    }
+
     if (!mPacketHandler.IsDropped()) {
         ShowPacketStatistics(aHeader);
-        Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+            Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        }
     }
 
     if (mAcknowledgePackets && mPacketHandler.IsAckable()) {
@@ -109,15 +134,18 @@ bool MonitorDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr*
         Send(lAcknowledgementFrame);
     }
 
+    // Set before sending, the connector reads the capture time from the header
+    SetData(aData);
+    SetHeader(aHeader);
+
     // If this packet is convertible to something XLink can understand, send
     if (mPacketHandler.ShouldSend()) {
-        std::string lPacket{mPacketHandler.ConvertPacketOut()};
+        const std::string_view lPacket{mPacketHandler.ConvertPacketOut()};
+        LatencyStatistics::GetInstance().Record(
+            LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Converted, aHeader);
         GetConnector()->Send(lPacket);
     }
 
-    SetData(aData);
-    SetHeader(aHeader);
-
     // For use in userinterface
     if (mCurrentlyConnectedNetwork != nullptr) {
         *mCurrentlyConnectedNetwork = mPacketHandler.GetLockedSSID();
@@ -143,18 +171,21 @@ uint64_t MonitorDevice::GetLockedBSSID()
 }
 
 bool MonitorDevice::Send(std::string_view aData)
+{
+    return Queue(aData) && Flush();
+}
+
+bool MonitorDevice::Queue(std::string_view aData)
 {
     bool lReturn{false};
     if (mPcapWrapper->IsActivated()) {
         if (!aData.empty()) {
-            Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(aData), Logger::Level::TRACE);
-
-            if (mPcapWrapper->SendPacket(aData) == 0) {
-                lReturn = true;
-            } else {
-                Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(mPcapWrapper->GetError()),
-                                          Logger::Level::ERROR);
+            if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(aData), Logger::Level::TRACE);
             }
+
+            AddToSendQueue(aData);
+            lReturn = true;
         }
     } else {
         Logger::GetInstance().Log("Cannot send packets on a device that has not been opened yet!",
@@ -164,6 +195,11 @@ bool MonitorDevice::Send(std::string_view aData)
     return lReturn;
 }
 
+bool MonitorDevice::Flush()
+{
+    return FlushSendQueue(*mPcapWrapper);
+}
+
 bool MonitorDevice::StartReceiverThread()
 {
     bool lReturn{true};
@@ -189,6 +225,8 @@ bool MonitorDevice::StartReceiverThread()
                             "Error occurred while reading packet: " + std::string(mPcapWrapper->GetError()),
                             Logger::Level::DEBUG);
                     }
+                    UpdateFilter(*mPcapWrapper);
+                    UpdateStatistics(*mPcapWrapper);
                 }
 
                 mSendReceivedData = lSendReceivedDataOld;
@@ -202,10 +240,45 @@ bool MonitorDevice::StartReceiverThread()
     return lReturn;
 }
 
+bool MonitorDevice::AddToReactor(std::shared_ptr<Reactor> aReactor)
+{
+    bool lReturn{false};
+
+    if (mPcapWrapper->IsActivated() && mReceiverThread == nullptr) {
+        const int lSelectableFd{mPcapWrapper->GetSelectableFd()};
+        if (lSelectableFd >= 0) {
+            // Only dispatch what is ready, never wait inside pcap
+            mPcapWrapper->SetNonBlock(1);
+
+            lReturn = aReactor->AddReadable(lSelectableFd, [&] {
+                auto lCallbackFunction =
+                    [](unsigned char* aThis, const pcap_pkthdr* aHeader, const unsigned char* aPacket) {
+                        auto* lThis = reinterpret_cast<MonitorDevice*>(aThis);
+                        lThis->ReadCallback(aPacket, aHeader);
+                    };
+
+                if (mPcapWrapper->Dispatch(-1, lCallbackFunction, reinterpret_cast<u_char*>(this)) == -1) {
+                    Logger::GetInstance().Log(
+                        "Error occurred while reading packet: " + std::string(mPcapWrapper->GetError()),
+                        Logger::Level::DEBUG);
+                }
+                UpdateFilter(*mPcapWrapper);
+                UpdateStatistics(*mPcapWrapper);
+            });
+        } else {
+            Logger::GetInstance().Log("Device can't be waited on, can't add it to a reactor", Logger::Level::ERROR);
+        }
+    } else {
+        Logger::GetInstance().Log("Can't add to reactor without a handler!", Logger::Level::ERROR);
+    }
+
+    return lReturn;
+}
+
 void MonitorDevice::SetSourceMacToFilter(uint64_t aMac)
 {
-    if (aMac != 0) {
-        mPacketHandler.GetBlackList().AddToMacWhiteList(aMac);
+    if (aMac != 0 && mPacketHandler.GetBlackList().AddToMacWhiteList(aMac)) {
+        RequestFilterUpdate();
     }
 }
 
@@ -2,6 +2,8 @@
 
 #include "PCapDeviceBase.h"
 
+#include <utility>
+
 #include "Logger.h"
 #include "PCapWrapper.h"
 
@@ -12,20 +14,24 @@ void PCapDeviceBase::SetConnector(std::shared_ptr<IConnector> aDevice)
 
 void PCapDeviceBase::ShowPacketStatistics(const pcap_pkthdr* aHeader) const
 {
-    Logger::GetInstance().Log("Packet # " + std::to_string(mPacketCount), Logger::Level::TRACE);
-
-    // Show the size in bytes of the packet
-    Logger::GetInstance().Log("Packet size: " + std::to_string(aHeader->len) + " bytes", Logger::Level::TRACE);
-
-    // Show Epoch Time
-    Logger::GetInstance().Log(
-        "Epoch time: " + std::to_string(aHeader->ts.tv_sec) + ":" + std::to_string(aHeader->ts.tv_usec),
-        Logger::Level::TRACE);
-
-    // Show a warning if the length captured is different
-    if (aHeader->len != aHeader->caplen) {
-        Logger::GetInstance().Log("Capture size different than packet size:" + std::to_string(aHeader->len) + " bytes",
-                                  Logger::Level::TRACE);
+    // Called for every packet, don't build any of these strings for nothing
+    if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+        Logger::GetInstance().Log("Packet # " + std::to_string(mPacketCount), Logger::Level::TRACE);
+
+        // Show the size in bytes of the packet
+        Logger::GetInstance().Log("Packet size: " + std::to_string(aHeader->len) + " bytes", Logger::Level::TRACE);
+
+        // Show Epoch Time
+        Logger::GetInstance().Log(
+            "Epoch time: " + std::to_string(aHeader->ts.tv_sec) + ":" + std::to_string(aHeader->ts.tv_usec),
+            Logger::Level::TRACE);
+
+        // Show a warning if the length captured is different
+        if (aHeader->len != aHeader->caplen) {
+            Logger::GetInstance().Log("Capture size different than packet size:" + std::to_string(aHeader->len) +
+                                          " bytes",
+                                      Logger::Level::TRACE);
+        }
     }
 }
 
@@ -66,19 +72,150 @@ void PCapDeviceBase::SetHeader(const pcap_pkthdr* aHeader)
 
 std::string PCapDeviceBase::DataToString(const unsigned char* aData, const pcap_pkthdr* aHeader)
 {
-    // Convert from char* to string
-    std::string lData{};
+    return std::string(DataToStringView(aData, aHeader));
+}
+
+std::string_view PCapDeviceBase::DataToStringView(const unsigned char* aData, const pcap_pkthdr* aHeader)
+{
+    std::string_view lData{};
 
     if ((aData != nullptr) && (aHeader != nullptr)) {
-        lData.resize(aHeader->caplen);
-        for (unsigned int lCount = 0; lCount < aHeader->caplen; lCount++) {
-            lData.at(lCount) = static_cast<char>(aData[lCount]);
-        }
+        lData = std::string_view(reinterpret_cast<const char*>(aData), aHeader->caplen);
     }
 
     return lData;
 }
 
+void PCapDeviceBase::AddToSendQueue(std::string_view aData)
+{
+    AddToSendQueue(aData, [](std::string& /*aSlot*/) {});
+}
+
+bool PCapDeviceBase::FlushSendQueue(IPCapWrapper& aWrapper)
+{
+    std::lock_guard<std::mutex> lFlushLock{mFlushMutex};
+
+    size_t lLength{0};
+    {
+        // Both queues keep their buffers, so swapping them doesn't allocate
+        std::lock_guard<std::mutex> lLock{mSendQueueMutex};
+        std::swap(mSendQueue, mFlushQueue);
+        lLength          = mSendQueueLength;
+        mSendQueueLength = 0;
+    }
+
+    bool lReturn{true};
+
+    if (lLength == 1) {
+        if (aWrapper.SendPacket(mFlushQueue.front()) != 0) {
+            Logger::GetInstance().Log("Sending packet failed, " + std::string(aWrapper.GetError()),
+                                      Logger::Level::ERROR);
+            lReturn = false;
+        }
+    } else if (lLength > 1) {
+        const int lSent{aWrapper.SendBatch({mFlushQueue.data(), lLength})};
+        if (lSent != static_cast<int>(lLength)) {
+            Logger::GetInstance().Log("Sending batch failed after " + std::to_string(lSent) + " of " +
+                                          std::to_string(lLength) + " packets, " + std::string(aWrapper.GetError()),
+                                      Logger::Level::ERROR);
+            lReturn = false;
+        }
+    }
+
+    return lReturn;
+}
+
+std::string PCapDeviceBase::BuildFilter()
+{
+    return {};
+}
+
+std::vector<uint64_t> PCapDeviceBase::BuildPassedSources()
+{
+    return {};
+}
+
+void PCapDeviceBase::RequestFilterUpdate()
+{
+    mFilterUpdateRequested = true;
+}
+
+void PCapDeviceBase::UpdateFilter(IPCapWrapper& aWrapper)
+{
+    if (mFilterUpdateRequested.exchange(false)) {
+        const std::string lFilter{BuildFilter()};
+
+        if (aWrapper.SetFilter(lFilter) == 0) {
+            Logger::GetInstance().Log("Capture filter set to: " + lFilter, Logger::Level::DEBUG);
+        } else {
+            Logger::GetInstance().Log("Could not set capture filter, " + std::string(aWrapper.GetError()),
+                                      Logger::Level::DEBUG);
+        }
+
+        if (aWrapper.SetPassedSources(BuildPassedSources()) != 0) {
+            Logger::GetInstance().Log("Could not pass sources to the kernel stack, " +
+                                          std::string(aWrapper.GetError()),
+                                      Logger::Level::WARNING);
+        }
+    }
+}
+
+void PCapDeviceBase::SetUpCaptureBuffer(IPCapWrapper& aWrapper)
+{
+    if (mCaptureBufferSize > 0) {
+        if (aWrapper.SetBufferSize(static_cast<int>(mCaptureBufferSize)) == 0) {
+            Logger::GetInstance().Log("Capture buffer size set to: " + std::to_string(mCaptureBufferSize) + " bytes",
+                                      Logger::Level::DEBUG);
+        } else {
+            Logger::GetInstance().Log("Could not set capture buffer size, using the default, " +
+                                          std::string(aWrapper.GetError()),
+                                      Logger::Level::WARNING);
+        }
+    }
+}
+
+void PCapDeviceBase::UpdateStatistics(IPCapWrapper& aWrapper)
+{
+    const auto lNow{std::chrono::steady_clock::now()};
+    if (lNow - mLastStatistics >= PCapDeviceBase_Constants::cStatisticsInterval) {
+        mLastStatistics = lNow;
+        CollectStatistics(aWrapper, Logger::Level::DEBUG);
+    }
+}
+
+void PCapDeviceBase::CollectStatistics(IPCapWrapper& aWrapper, Logger::Level aLevel)
+{
+    pcap_stat lStatistics{};
+
+    if (aWrapper.IsActivated() && aWrapper.GetStatistics(&lStatistics) == 0) {
+        const uint64_t lPreviousDropped{mDropped.exchange(lStatistics.ps_drop)};
+        mReceived         = lStatistics.ps_recv;
+        mInterfaceDropped = lStatistics.ps_ifdrop;
+
+        Logger::GetInstance().Log("Capture statistics, received: " + std::to_string(lStatistics.ps_recv) +
+                                      ", dropped: " + std::to_string(lStatistics.ps_drop) +
+                                      ", dropped by interface: " + std::to_string(lStatistics.ps_ifdrop),
+                                  aLevel);
+
+        if (lStatistics.ps_drop > lPreviousDropped) {
+            Logger::GetInstance().Log("Capture buffer overflowed, " +
+                                          std::to_string(lStatistics.ps_drop - lPreviousDropped) +
+                                          " packets dropped, consider raising CaptureBufferSizeKiB",
+                                      Logger::Level::WARNING);
+        }
+    }
+}
+
+IPCapDevice_Constants::CaptureStatistics PCapDeviceBase::GetCaptureStatistics()
+{
+    return {mReceived, mDropped, mInterfaceDropped};
+}
+
+void PCapDeviceBase::SetCaptureBufferSize(unsigned int aBufferSize)
+{
+    mCaptureBufferSize = aBufferSize;
+}
+
 void PCapDeviceBase::SetHosting(bool aHosting)
 {
     mHosting = aHosting;
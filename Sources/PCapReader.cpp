@@ -20,9 +20,8 @@ PCapReader::PCapReader(bool                          aMonitorCapture,
 
 void PCapReader::BlackList(uint64_t aMac)
 {
-    auto lHandler = std::dynamic_pointer_cast<Handler80211>(mPacketHandler);
-    if (lHandler != nullptr) {
-        mPacketHandler->GetBlackList().AddToMacBlackList(aMac);
+    if (mMonitorHandler != nullptr) {
+        mMonitorHandler->GetBlackList().AddToMacBlackList(aMac);
     }
 }
 
@@ -51,11 +50,8 @@ uint64_t PCapReader::GetBSSID() const
 {
     uint64_t lBSSID{mBSSID};
 
-    if (mMonitorCapture) {
-        auto lHandler = std::dynamic_pointer_cast<Handler80211>(mPacketHandler);
-        if (lHandler != nullptr) {
-            lBSSID = lHandler->GetLockedBSSID();
-        }
+    if (mMonitorCapture && (mMonitorHandler != nullptr)) {
+        lBSSID = mMonitorHandler->GetLockedBSSID();
     }
 
     return lBSSID;
@@ -70,12 +66,9 @@ std::shared_ptr<RadioTapReader::PhysicalDeviceParameters> PCapReader::GetDataPar
 {
     std::shared_ptr<RadioTapReader::PhysicalDeviceParameters> lParameters{mParameters};
 
-    if (mMonitorCapture) {
-        auto lHandler = std::dynamic_pointer_cast<Handler80211>(mPacketHandler);
-        if (lHandler != nullptr) {
-            lParameters =
-                std::make_shared<RadioTapReader::PhysicalDeviceParameters>(lHandler->GetDataPacketParameters());
-        }
+    if (mMonitorCapture && (mMonitorHandler != nullptr)) {
+        lParameters =
+            std::make_shared<RadioTapReader::PhysicalDeviceParameters>(mMonitorHandler->GetDataPacketParameters());
     }
 
     return lParameters;
@@ -90,7 +83,9 @@ bool PCapReader::Open(std::string_view aArgument)
 {
     mMonitorCapture = false;
     // Create an 8023 handler, this is going to be a promiscuous capture
-    mPacketHandler = std::make_shared<Handler8023>();
+    mPromiscuousHandler = std::make_shared<Handler8023>();
+    mMonitorHandler     = nullptr;
+    mPacketHandler      = mPromiscuousHandler;
 
     bool                               lReturn{true};
     std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
@@ -110,15 +105,15 @@ bool PCapReader::Open(std::string_view aName, std::vector<std::string>& aSSIDFil
 {
     mMonitorCapture = true;
     // Create an 80211 handler, this is going to ge a monitor capture
-    mPacketHandler = std::make_shared<Handler80211>();
+    mMonitorHandler     = std::make_shared<Handler80211>();
+    mPromiscuousHandler = nullptr;
+    mPacketHandler      = mMonitorHandler;
 
     bool                               lReturn{true};
     std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
     mWrapper->OpenOffline(aName.data(), lErrorBuffer.data());
     if (mWrapper->IsActivated()) {
-        // If we have a monitor device we want the 80211 handler.
-        auto lHandler{std::dynamic_pointer_cast<Handler80211>(mPacketHandler)};
-        lHandler->SetSSIDFilterList(aSSIDFilter);
+        mMonitorHandler->SetSSIDFilterList(aSSIDFilter);
     } else {
         lReturn = false;
         Logger::GetInstance().Log("pcap_open_offline failed, " + std::string(lErrorBuffer.data()),
@@ -133,23 +128,25 @@ bool PCapReader::ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHe
     bool lReturn{false};
 
     // Load all needed information into the handler
-    std::string lData{DataToString(aData, aHeader)};
-
-    mPacketHandler->Update(lData);
+    std::string_view lData{DataToStringView(aData, aHeader)};
 
     if (mMonitorCapture) {
         // If we have a monitor device we want the 80211 handler.
-        auto lHandler{std::dynamic_pointer_cast<Handler80211>(mPacketHandler)};
+        Handler80211* lHandler{mMonitorHandler.get()};
 
         if (lHandler != nullptr) {
+            lHandler->Update(lData);
+
             if (!lHandler->IsDropped()) {
                 ShowPacketStatistics(aHeader);
-                Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+                if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                    Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+                }
             }
 
             if (mAcknowledgePackets && lHandler->IsAckable()) {
                 std::string lAcknowledgementFrame = ConstructAcknowledgementFrame(
-                    mPacketHandler->GetSourceMac(), lHandler->GetControlPacketParameters());
+                    lHandler->GetSourceMac(), lHandler->GetControlPacketParameters());
 
                 Logger::GetInstance().Log("Sent ACK", Logger::Level::TRACE);
                 Send(lAcknowledgementFrame);
@@ -161,12 +158,13 @@ bool PCapReader::ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHe
             }
         }
     } else {
+        mPacketHandler->Update(lData);
+
         // Pretending to be XLink Kai or other outgoing connector
         if (mIncomingConnection != nullptr) {
             if (mMonitorOutput) {
-                auto lHandler = std::dynamic_pointer_cast<Handler8023>(mPacketHandler);
-                if (lHandler != nullptr) {
-                    mIncomingConnection->Send(lHandler->ConvertPacketOut(mBSSID, *mParameters));
+                if (mPromiscuousHandler != nullptr) {
+                    mIncomingConnection->Send(mPromiscuousHandler->ConvertPacketOut(mBSSID, *mParameters));
                 }
             } else {
                 mIncomingConnection->Send(lData);
@@ -219,7 +217,10 @@ bool PCapReader::Send(std::string_view aData)
     bool lReturn{false};
     if (mWrapper->IsActivated()) {
         if (!aData.empty()) {
-            Logger::GetInstance().Log(std::string("Would have sent: ") + PrettyHexString(aData), Logger::Level::TRACE);
+            if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                Logger::GetInstance().Log(std::string("Would have sent: ") + PrettyHexString(aData),
+                                          Logger::Level::TRACE);
+            }
         }
     } else {
         Logger::GetInstance().Log("Cannot send packets on a device that has not been opened yet!",
@@ -229,6 +230,17 @@ bool PCapReader::Send(std::string_view aData)
     return lReturn;
 }
 
+bool PCapReader::Queue(std::string_view aData)
+{
+    // Nothing to batch when pretending, just show what would have been sent
+    return Send(aData);
+}
+
+bool PCapReader::Flush()
+{
+    return true;
+}
+
 void PCapReader::SetBSSID(uint64_t aBSSID)
 {
     mBSSID = aBSSID;
@@ -244,6 +256,13 @@ void PCapReader::SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice)
     mIncomingConnection = aDevice;
 }
 
+bool PCapReader::AddToReactor(std::shared_ptr<Reactor> /*aReactor*/)
+{
+    // Files are replayed on their own timing, use StartReceiverThread instead
+    Logger::GetInstance().Log("A PCapReader can't be added to a reactor", Logger::Level::ERROR);
+    return false;
+}
+
 bool PCapReader::StartReceiverThread()
 {
     bool lReturn{true};
@@ -2,6 +2,10 @@
 
 #include "PCapWrapper.h"
 
+#include <array>
+#include <cerrno>
+#include <string>
+
 int PCapWrapper::Activate()
 {
     return pcap_activate(mHandler);
@@ -73,6 +77,21 @@ char* PCapWrapper::GetError()
     return pcap_geterr(mHandler);
 }
 
+int PCapWrapper::GetSelectableFd()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    // Not available on Windows, there is no way to wait on the handle
+    return -1;
+#else
+    return pcap_get_selectable_fd(mHandler);
+#endif
+}
+
+int PCapWrapper::GetStatistics(pcap_stat* stats)
+{
+    return pcap_stats(mHandler, stats);
+}
+
 pcap_t* PCapWrapper::OpenDead(int linktype, int snaplen)
 {
     mHandler = pcap_open_dead(linktype, snaplen);
@@ -96,16 +115,94 @@ int PCapWrapper::SendPacket(std::string_view buffer)
         mHandler, reinterpret_cast<const unsigned char*>(buffer.data()), static_cast<int>(buffer.size()));
 }
 
+int PCapWrapper::SendBatch(std::span<const std::string> buffers)
+{
+    int  lSent{0};
+    bool lFailed{false};
+
+#ifdef __linux__
+    // A live capture on Linux is a packet socket bound to the interface, which is also what pcap_sendpacket writes
+    // to, so the whole batch can be injected with as few syscalls as possible.
+    int lSocket{pcap_get_selectable_fd(mHandler)};
+    if (lSocket >= 0 && !buffers.empty()) {
+        if (mBatchHeaders.size() < buffers.size()) {
+            mBatchHeaders.resize(buffers.size());
+            mBatchVectors.resize(buffers.size());
+        }
+
+        for (size_t lCount = 0; lCount < buffers.size(); lCount++) {
+            mmsghdr& lHeader{mBatchHeaders.at(lCount)};
+            mBatchVectors.at(lCount)   = {const_cast<char*>(buffers[lCount].data()), buffers[lCount].size()};
+            lHeader                    = {};
+            lHeader.msg_hdr.msg_iov    = &mBatchVectors.at(lCount);
+            lHeader.msg_hdr.msg_iovlen = 1;
+        }
+
+        // sendmmsg may send only part of the batch, so keep going until everything is out
+        while (!lFailed && lSent < static_cast<int>(buffers.size())) {
+            int lResult{sendmmsg(lSocket, mBatchHeaders.data() + lSent, buffers.size() - lSent, 0)};
+            if (lResult > 0) {
+                lSent += lResult;
+            } else if (lResult < 0 && errno == ENOTSOCK && lSent == 0) {
+                // Not a socket (e.g. a savefile), let pcap deal with it below
+                break;
+            } else {
+                lFailed = true;
+            }
+        }
+    }
+#endif
+
+    for (size_t lCount = lSent; !lFailed && lCount < buffers.size(); lCount++) {
+        if (SendPacket(buffers[lCount]) == 0) {
+            lSent++;
+        } else {
+            lFailed = true;
+        }
+    }
+
+    return lFailed ? -1 : lSent;
+}
+
+int PCapWrapper::SetBufferSize(int buffer_size)
+{
+    return pcap_set_buffer_size(mHandler, buffer_size);
+}
+
 int PCapWrapper::SetDirection(PcapDirection::Direction direction)
 {
     return pcap_setdirection(mHandler, static_cast<pcap_direction_t>(direction));
 }
 
+int PCapWrapper::SetFilter(std::string_view filter)
+{
+    int         lReturn{PCAP_ERROR};
+    bpf_program lProgram{};
+
+    if (pcap_compile(mHandler, &lProgram, std::string(filter).c_str(), 1, PCAP_NETMASK_UNKNOWN) == 0) {
+        lReturn = pcap_setfilter(mHandler, &lProgram);
+        pcap_freecode(&lProgram);
+    }
+
+    return lReturn;
+}
+
 int PCapWrapper::SetImmediateMode(int mode)
 {
     return pcap_set_immediate_mode(mHandler, mode);
 }
 
+int PCapWrapper::SetNonBlock(int nonblock)
+{
+    std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+    return pcap_setnonblock(mHandler, nonblock, lErrorBuffer.data());
+}
+
+int PCapWrapper::SetPassedSources(const std::vector<uint64_t>& /*sources*/)
+{
+    return 0;
+}
+
 int PCapWrapper::SetSnapLen(int snaplen)
 {
     return pcap_set_snaplen(mHandler, snaplen);
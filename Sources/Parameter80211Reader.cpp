@@ -2,6 +2,7 @@
 
 #include "Parameter80211Reader.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "NetConversionFunctions.h"
@@ -10,7 +11,20 @@ Parameter80211Reader::Parameter80211Reader(std::shared_ptr<RadioTapReader> aPhys
     mPhysicalDeviceHeaderReader(std::move(aPhysicalDeviceHeaderReader))
 {}
 
-uint8_t Parameter80211Reader::GetFrequency() const
+std::vector<IPCapDevice_Constants::WiFiBeaconInformation> Parameter80211Reader::GetAdhocNetworks() const
+{
+    std::vector<IPCapDevice_Constants::WiFiBeaconInformation> lReturn{};
+
+    for (const auto& lBeacon : mBeaconCache) {
+        if (lBeacon.Information.IsAdhoc) {
+            lReturn.push_back(lBeacon.Information);
+        }
+    }
+
+    return lReturn;
+}
+
+uint16_t Parameter80211Reader::GetFrequency() const
 {
     return mFrequency;
 }
@@ -30,13 +44,10 @@ bool Parameter80211Reader::GetIsAdhoc() const
     return mIsAdhoc;
 }
 
-void Parameter80211Reader::Update(std::string_view aData)
+void Parameter80211Reader::Update(std::string_view aData, uint64_t aBSSID)
 {
     mLastReceivedPacket = aData;
-
-    // Re-obtain this
-    mMaxRate = 0;
-    mIsAdhoc = false;
+    mUpdateCount++;
 
     // If there is an FCS remove 4 bytes from total length
     unsigned int lFCSLength =
@@ -51,15 +62,73 @@ void Parameter80211Reader::Update(std::string_view aData)
     if (mPhysicalDeviceHeaderReader != nullptr) {
         lIndex += mPhysicalDeviceHeaderReader->GetLength();
     }
-    lIndex += static_cast<uint16_t>(Net_80211_Constants::cFixedParameterTypeSSIDIndex + 1);
+    lIndex += static_cast<uint16_t>(Net_80211_Constants::cFixedParameterTypeSSIDIndex);
+
+    if (lIndex + lFCSLength < aData.length()) {
+        const unsigned int lEnd{static_cast<unsigned int>(aData.length()) - lFCSLength};
+
+        // FNV-1a over all parameters, the fixed fields before them (like the timestamp) change every beacon
+        uint64_t lHash{0xcbf29ce484222325ULL};
+        for (unsigned int lCount = lIndex; lCount < lEnd; lCount++) {
+            lHash = (lHash ^ static_cast<uint8_t>(aData[lCount])) * 0x100000001b3ULL;
+        }
+
+        auto lBeacon = std::find_if(mBeaconCache.begin(), mBeaconCache.end(), [&](const CachedBeacon& aBeacon) {
+            return aBeacon.Information.BSSID == aBSSID;
+        });
+
+        if (lBeacon == mBeaconCache.end() || lBeacon->Hash != lHash) {
+            ParseParameters(aData, lIndex, lEnd);
+
+            if (lBeacon == mBeaconCache.end()) {
+                if (mBeaconCache.size() < Parameter80211Reader_Constants::cBeaconCacheSize) {
+                    lBeacon = mBeaconCache.emplace(mBeaconCache.end());
+                } else {
+                    // Make room by forgetting the network that has not been seen for the longest time
+                    lBeacon = std::min_element(mBeaconCache.begin(),
+                                               mBeaconCache.end(),
+                                               [](const CachedBeacon& aLeft, const CachedBeacon& aRight) {
+                                                   return aLeft.LastSeen < aRight.LastSeen;
+                                               });
+                }
+            }
+
+            lBeacon->Hash                  = lHash;
+            lBeacon->Information.BSSID     = aBSSID;
+            lBeacon->Information.SSID      = mSSID;
+            lBeacon->Information.MaxRate   = mMaxRate;
+            lBeacon->Information.Frequency = mFrequency;
+            lBeacon->Information.IsAdhoc   = mIsAdhoc;
+        } else {
+            // Nothing changed, no need to parse everything again
+            mSSID      = lBeacon->Information.SSID;
+            mMaxRate   = lBeacon->Information.MaxRate;
+            mFrequency = lBeacon->Information.Frequency;
+            mIsAdhoc   = lBeacon->Information.IsAdhoc;
+        }
+
+        lBeacon->LastSeen = mUpdateCount;
+    } else {
+        Reset();
+    }
+}
+
+void Parameter80211Reader::ParseParameters(std::string_view aData, uint16_t aIndex, unsigned int aEnd)
+{
+    // Re-obtain this
+    mFrequency = 0;
+    mMaxRate   = 0;
+    mIsAdhoc   = false;
+
+    uint16_t lIndex{static_cast<uint16_t>(aIndex + 1)};
 
     uint8_t lParameterLength{UpdateSSID(lIndex)};
     lIndex++;
 
     if (lParameterLength > 0) {
-        // Then go fill out all the others, always adding +1 to skip past the type info
-        lIndex = lIndex + lParameterLength + 1;
-        while (lIndex < (aData.length()) - lFCSLength) {
+        // Then go fill out all the others, the SSID ends right at the type info of the next one
+        lIndex = lIndex + lParameterLength;
+        while (lIndex < aEnd) {
             auto lParameterType = GetRawData<uint8_t>(aData, lIndex);
             switch (lParameterType) {
                 case Net_80211_Constants::cFixedParameterTypeSupportedRates:
@@ -90,7 +159,7 @@ uint8_t Parameter80211Reader::UpdateChannelInfo(uint16_t aIndex)
     // Don't need to know the size for channel, so just grab the channel immediately
     auto lChannel = GetRawData<uint8_t>(mLastReceivedPacket, aIndex + 1);
 
-    mFrequency = ConvertChannelToFrequency(lChannel);
+    mFrequency = static_cast<uint16_t>(ConvertChannelToFrequency(lChannel));
 
     return 1;
 }
@@ -130,6 +199,7 @@ uint8_t Parameter80211Reader::UpdateSSID(uint16_t aIndex)
 void Parameter80211Reader::Reset()
 {
     mFrequency = 0;
+    mIsAdhoc   = false;
     mMaxRate   = 0;
-    mSSID      = "";
+    mSSID.clear();
 }
@@ -2,14 +2,59 @@
 
 #include "RadioTapReader.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+
 #include "NetConversionFunctions.h"
 
+namespace
+{
+    /**
+     * Alignment and size of a radiotap field, see https://www.radiotap.org/fields/defined.
+     */
+    struct FieldDescriptor
+    {
+        uint8_t Alignment;
+        uint8_t Size;
+    };
+
+    // Indexed by the bit of the field in the present flags, up to and including the last field we can decode (MCS)
+    constexpr std::array<FieldDescriptor, 20> cFieldDescriptors{{
+        {8, 8},  // TSFT
+        {1, 1},  // Flags
+        {1, 1},  // Rate
+        {2, 4},  // Channel
+        {2, 2},  // FHSS
+        {1, 1},  // Antenna signal
+        {1, 1},  // Antenna noise
+        {2, 2},  // Lock quality
+        {2, 2},  // TX attenuation
+        {2, 2},  // dB TX attenuation
+        {1, 1},  // dBm TX power
+        {1, 1},  // Antenna
+        {1, 1},  // dB antenna signal
+        {1, 1},  // dB antenna noise
+        {2, 2},  // RX flags
+        {2, 2},  // TX flags
+        {1, 1},  // RTS retries
+        {1, 1},  // Data retries
+        {4, 8},  // XChannel
+        {1, 3},  // MCS
+    }};
+
+    // All alignments have to be powers of two for the alignment calculation to work
+    static_assert(std::all_of(cFieldDescriptors.begin(), cFieldDescriptors.end(), [](const FieldDescriptor& aField) {
+        return aField.Alignment != 0 && (aField.Alignment & (aField.Alignment - 1)) == 0;
+    }));
+}  // namespace
+
 RadioTapReader::PhysicalDeviceParameters RadioTapReader::ExportRadioTapParameters()
 {
     return mParameters;
 }
 
-void RadioTapReader::FillRadioTapParameters(std::string_view aData)
+void RadioTapReader::FillRadioTapParameters(std::string_view aData, uint32_t aFields)
 {
     // Start with default parameters
     Reset();
@@ -17,144 +62,77 @@ void RadioTapReader::FillRadioTapParameters(std::string_view aData)
     // Skip 2 bytes to skip header revision and header pad
     auto lLength = GetRawData<uint16_t>(aData, RadioTap_Constants::cLengthIndex);
 
-    if (lLength <= RadioTap_Constants::cMaxLength) {
+    if (lLength <= RadioTap_Constants::cMaxLength && lLength <= aData.size() &&
+        lLength >= RadioTap_Constants::cPresentFlagsIndex + sizeof(uint32_t)) {
         // Valid length, we can start saving parameters
         mParameters.mLength = lLength;
 
         // What fields do we have?
         mParameters.mPresentFlags = GetRawData<uint32_t>(aData, RadioTap_Constants::cPresentFlagsIndex);
 
-        uint8_t lIndex{RadioTap_Constants::cPresentFlagsIndex};
+        unsigned int lIndex{RadioTap_Constants::cPresentFlagsIndex};
 
         // If extended radiotap, skip past it
-        while ((GetRawData<uint32_t>(aData, lIndex) & 0x20000000U) != 0) {
+        while (lIndex + sizeof(uint32_t) < lLength && (GetRawData<uint32_t>(aData, lIndex) & 0x20000000U) != 0) {
             lIndex += 4;
         }
 
         // And skip past the last one
         lIndex += 4;
 
-        if ((mParameters.mPresentFlags & 1U) == 1) {
-            if (lIndex % 8 != 0) {
-                lIndex += lIndex % 8;
-            }
-            // TSFT, don't care, skip over it
-            lIndex += sizeof(uint64_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 1U)) != 0) {
-            // Flags, contains important information like datapad and fcs at the end of a packet
-            mParameters.mFlags = GetRawData<uint8_t>(aData, lIndex);
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 2U)) != 0) {
-            // Rate
-            mParameters.mDataRate = GetRawData<uint8_t>(aData, lIndex);
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 3U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // Channel and channel flags
-            mParameters.mFrequency = GetRawData<uint16_t>(aData, lIndex);
-            lIndex += sizeof(uint16_t);
-            mParameters.mChannelFlags = GetRawData<uint16_t>(aData, lIndex);
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 4U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // FHSS, don't care skip over it
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 5U)) != 0) {
-            // Antenna signal, Don't care skip over it
-            lIndex += sizeof(int8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 6U)) != 0) {
-            // Antenna Noise, Don't care skip over it
-            lIndex += sizeof(int8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 7U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // Lock Quality, Don't care skip over it
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 8U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // TX attenuation, Don't care skip over it
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 9U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // dB TX attenuation, Don't care skip over it
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 10U)) != 0) {
-            // dBm TX power, Don't care skip over it
-            lIndex += sizeof(int8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 11U)) != 0) {
-            // Antenna, Don't care skip over it
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 12U)) != 0) {
-            // dB antenna signal, Don't care skip over it
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 13U)) != 0) {
-            // dB antenna noise, Don't care skip over it
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 14U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // RX Flags, Don't care skip over it
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 15U)) != 0) {
-            if (lIndex % 2 != 0) {
-                lIndex += lIndex % 2;
-            }
-            // TX Flags, Don't care skip over it
-            lIndex += sizeof(uint16_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 16U)) != 0) {
-            // RTS Retries Don't care skip over it
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 17U)) != 0) {
-            // Data retries, Don't care skip over it
-            lIndex += sizeof(uint8_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 18U)) != 0) {
-            if (lIndex % 8 != 0) {
-                lIndex += lIndex % 8;
-            }
-            // XChannel, Don't care skip over it
-            lIndex += sizeof(uint64_t);
-        }
-        if ((mParameters.mPresentFlags & (1U << 19U)) != 0) {
-            // Fill MCS info
-            mParameters.mKnownMCSInfo = GetRawData<uint8_t>(aData, lIndex);
-            mParameters.mMCSFlags     = GetRawData<uint8_t>(aData, lIndex + 1);
-            mParameters.mMCSInfo      = GetRawData<uint8_t>(aData, lIndex + 2);
+        // Only walk up to the last field that was asked for, fields after that don't need to be skipped
+        const uint32_t lWantedFields{mParameters.mPresentFlags & aFields & ((1U << cFieldDescriptors.size()) - 1)};
+        const int      lLastField{lWantedFields != 0 ? static_cast<int>(std::bit_width(lWantedFields)) - 1 : -1};
 
-            lIndex += sizeof(uint8_t) * 3;
+        for (int lField = 0; lField <= lLastField; lField++) {
+            if ((mParameters.mPresentFlags & (1U << static_cast<unsigned int>(lField))) != 0) {
+                const FieldDescriptor& lDescriptor{cFieldDescriptors.at(lField)};
+
+                // Fields are aligned to their natural size
+                lIndex = (lIndex + lDescriptor.Alignment - 1) & ~(lDescriptor.Alignment - 1U);
+
+                if (lIndex + lDescriptor.Size > lLength) {
+                    // Broken header, don't read outside of it
+                    break;
+                }
+
+                if ((lWantedFields & (1U << static_cast<unsigned int>(lField))) != 0) {
+                    ReadField(aData, static_cast<uint32_t>(1U << static_cast<unsigned int>(lField)), lIndex);
+                }
+
+                lIndex += lDescriptor.Size;
+            }
         }
 
         // Don't care about any of the other flags yet, so just don't read them yet
     }
 }
 
+void RadioTapReader::ReadField(std::string_view aData, uint32_t aField, unsigned int aIndex)
+{
+    switch (aField) {
+        case RadioTap_Constants::cFlagsField:
+            // Flags, contains important information like datapad and fcs at the end of a packet
+            mParameters.mFlags = GetRawData<uint8_t>(aData, aIndex);
+            break;
+        case RadioTap_Constants::cRateField:
+            mParameters.mDataRate = GetRawData<uint8_t>(aData, aIndex);
+            break;
+        case RadioTap_Constants::cChannelField:
+            // Channel and channel flags
+            mParameters.mFrequency    = GetRawData<uint16_t>(aData, aIndex);
+            mParameters.mChannelFlags = GetRawData<uint16_t>(aData, aIndex + sizeof(uint16_t));
+            break;
+        case RadioTap_Constants::cMCSField:
+            mParameters.mKnownMCSInfo = GetRawData<uint8_t>(aData, aIndex);
+            mParameters.mMCSFlags     = GetRawData<uint8_t>(aData, aIndex + 1);
+            mParameters.mMCSInfo      = GetRawData<uint8_t>(aData, aIndex + 2);
+            break;
+        default:
+            break;
+    }
+}
+
 uint16_t RadioTapReader::GetLength() const
 {
     return mParameters.mLength;
@@ -0,0 +1,157 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Reactor.cpp */
+
+#include "Reactor.h"
+
+#include <algorithm>
+#include <array>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+namespace
+{
+    constexpr int cMaxEvents{16};
+}  // namespace
+
+Reactor::Reactor()
+{
+#ifdef __linux__
+    mEpoll     = epoll_create1(EPOLL_CLOEXEC);
+    mStopEvent = eventfd(0, EFD_CLOEXEC);
+
+    if (mEpoll >= 0 && mStopEvent >= 0) {
+        epoll_event lEvent{};
+        lEvent.events  = EPOLLIN;
+        lEvent.data.fd = mStopEvent;
+        epoll_ctl(mEpoll, EPOLL_CTL_ADD, mStopEvent, &lEvent);
+    } else {
+        Logger::GetInstance().Log("Could not create epoll instance for the reactor", Logger::Level::ERROR);
+    }
+#endif
+}
+
+Reactor::~Reactor()
+{
+    Stop();
+
+#ifdef __linux__
+    if (mStopEvent >= 0) {
+        close(mStopEvent);
+    }
+
+    if (mEpoll >= 0) {
+        close(mEpoll);
+    }
+#endif
+}
+
+bool Reactor::AddReadable(int aFileDescriptor, Callback aCallback)
+{
+    bool lReturn{false};
+
+#ifdef __linux__
+    epoll_event lEvent{};
+    lEvent.events  = EPOLLIN;
+    lEvent.data.fd = aFileDescriptor;
+
+    if (mEpoll >= 0 && epoll_ctl(mEpoll, EPOLL_CTL_ADD, aFileDescriptor, &lEvent) == 0) {
+        mReadables[aFileDescriptor] = std::move(aCallback);
+        lReturn                     = true;
+    } else {
+        Logger::GetInstance().Log("Could not add file descriptor " + std::to_string(aFileDescriptor) + " to reactor",
+                                  Logger::Level::ERROR);
+    }
+#else
+    Logger::GetInstance().Log("The reactor is not supported on this platform", Logger::Level::ERROR);
+#endif
+
+    return lReturn;
+}
+
+void Reactor::RemoveReadable(int aFileDescriptor)
+{
+#ifdef __linux__
+    if (mReadables.erase(aFileDescriptor) > 0) {
+        epoll_ctl(mEpoll, EPOLL_CTL_DEL, aFileDescriptor, nullptr);
+    }
+#endif
+}
+
+void Reactor::AddTimer(std::chrono::milliseconds aInterval, Callback aCallback)
+{
+    mTimers.push_back({aInterval, std::chrono::steady_clock::now() + aInterval, std::move(aCallback)});
+}
+
+bool Reactor::Start()
+{
+    bool lReturn{false};
+
+#ifdef __linux__
+    if (mEpoll >= 0 && mStopEvent >= 0 && mThread == nullptr) {
+        mRunning = true;
+        mThread  = std::make_shared<std::thread>([&] { Run(); });
+        lReturn  = true;
+    }
+#else
+    Logger::GetInstance().Log("The reactor is not supported on this platform", Logger::Level::ERROR);
+#endif
+
+    return lReturn;
+}
+
+void Reactor::Stop()
+{
+#ifdef __linux__
+    if (mThread != nullptr) {
+        mRunning = false;
+        eventfd_write(mStopEvent, 1);
+
+        mThread->join();
+        mThread = nullptr;
+    }
+#endif
+}
+
+void Reactor::Run()
+{
+#ifdef __linux__
+    std::array<epoll_event, cMaxEvents> lEvents{};
+
+    while (mRunning) {
+        // Sleep until the first timer is due, or indefinitely if there are no timers
+        int lTimeoutMs{-1};
+        if (!mTimers.empty()) {
+            auto lNext = std::min_element(mTimers.begin(), mTimers.end(), [](const Timer& aLeft, const Timer& aRight) {
+                             return aLeft.Next < aRight.Next;
+                         })->Next;
+
+            lTimeoutMs = static_cast<int>(std::max<int64_t>(
+                0,
+                std::chrono::ceil<std::chrono::milliseconds>(lNext - std::chrono::steady_clock::now()).count()));
+        }
+
+        int lAmount{epoll_wait(mEpoll, lEvents.data(), cMaxEvents, lTimeoutMs)};
+
+        for (int lCount = 0; lCount < lAmount && mRunning; lCount++) {
+            // A callback before this one might have removed this file descriptor
+            auto lReadable = mReadables.find(lEvents.at(lCount).data.fd);
+            if (lReadable != mReadables.end()) {
+                lReadable->second();
+            }
+        }
+
+        const auto lNow{std::chrono::steady_clock::now()};
+        for (auto& lTimer : mTimers) {
+            if (mRunning && lTimer.Next <= lNow) {
+                lTimer.Next = lNow + lTimer.Interval;
+                lTimer.Function();
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,645 @@
+/* Copyright (c) 2021 [Rick de Bondt] - TPacketWrapperLinux.cpp */
+
+#include "TPacketWrapperLinux.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Logger.h"
+
+using namespace TPacketWrapper_Constants;
+
+namespace
+{
+    // Injected frames start where the kernel would have put the link layer address, see tpacket_fill_skb
+    constexpr unsigned int cSendDataOffset{TPACKET_ALIGN(sizeof(tpacket3_hdr))};
+    constexpr unsigned int cSendBlockSize{cSendFrameSize * cSendFramesPerBlock};
+    constexpr unsigned int cSendFrameCount{cSendFramesPerBlock * cSendBlockCount};
+
+    uint32_t LoadStatus(uint32_t& aStatus)
+    {
+        return std::atomic_ref<uint32_t>(aStatus).load(std::memory_order_acquire);
+    }
+
+    void StoreStatus(uint32_t& aStatus, uint32_t aValue)
+    {
+        std::atomic_ref<uint32_t>(aStatus).store(aValue, std::memory_order_release);
+    }
+}  // namespace
+
+TPacketWrapper::TPacketWrapper(unsigned int aBlockSize, std::chrono::milliseconds aBlockTimeOut) :
+    mBlockSize(aBlockSize), mBlockTimeOut(aBlockTimeOut)
+{}
+
+TPacketWrapper::~TPacketWrapper()
+{
+    Close();
+}
+
+int TPacketWrapper::Activate()
+{
+    int lReturn{0};
+
+    const unsigned int lIndex{if_nametoindex(mInterface.c_str())};
+    const auto         lPageSize{static_cast<unsigned int>(sysconf(_SC_PAGESIZE))};
+
+    if (IsActivated()) {
+        lReturn = PCAP_ERROR_ACTIVATED;
+    } else if (lIndex == 0) {
+        SetError("No such device: " + mInterface);
+        lReturn = PCAP_ERROR_NO_SUCH_DEVICE;
+    } else {
+        // Only bind to a protocol once the rings are there, so nothing gets queued outside of them
+        mSocket     = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+        mBreakEvent = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (mSocket < 0) {
+            SetError(std::string("Could not create packet socket: ") + strerror(errno));
+            lReturn = (errno == EPERM || errno == EACCES) ? PCAP_ERROR_PERM_DENIED : PCAP_ERROR;
+        } else if (mBreakEvent < 0) {
+            // BreakLoop would not be able to wake up a blocking Dispatch
+            SetError(std::string("Could not create break event: ") + strerror(errno));
+            lReturn = PCAP_ERROR;
+        }
+    }
+
+    if (lReturn == 0) {
+        // Blocks have to be whole pages
+        mBlockSize = ((std::max(mBlockSize, lPageSize) + lPageSize - 1) / lPageSize) * lPageSize;
+
+        int          lVersion{TPACKET_V3};
+        tpacket_req3 lReceiveRequest{};
+        tpacket_req3 lSendRequest{};
+        sockaddr_ll  lAddress{};
+        unsigned int lFrameSize{TPACKET_ALIGNMENT << 7U};
+
+        lReceiveRequest.tp_block_size     = mBlockSize;
+        lReceiveRequest.tp_block_nr       = mBlockCount;
+        lReceiveRequest.tp_frame_size     = lFrameSize;
+        lReceiveRequest.tp_frame_nr       = (mBlockSize / lFrameSize) * mBlockCount;
+        lReceiveRequest.tp_retire_blk_tov = static_cast<unsigned int>(mBlockTimeOut.count());
+
+        lSendRequest.tp_block_size = cSendBlockSize;
+        lSendRequest.tp_block_nr   = cSendBlockCount;
+        lSendRequest.tp_frame_size = cSendFrameSize;
+        lSendRequest.tp_frame_nr   = cSendFrameCount;
+
+        lAddress.sll_family   = AF_PACKET;
+        lAddress.sll_protocol = htons(ETH_P_ALL);
+        lAddress.sll_ifindex  = static_cast<int>(lIndex);
+
+        mReceiveRingSize = static_cast<size_t>(mBlockSize) * mBlockCount;
+
+        if (setsockopt(mSocket, SOL_PACKET, PACKET_VERSION, &lVersion, sizeof(lVersion)) != 0) {
+            SetError(std::string("TPACKET_V3 is not supported: ") + strerror(errno));
+            lReturn = PCAP_ERROR;
+        } else if (setsockopt(mSocket, SOL_PACKET, PACKET_RX_RING, &lReceiveRequest, sizeof(lReceiveRequest)) != 0) {
+            SetError(std::string("Could not set up receive ring: ") + strerror(errno));
+            lReturn = PCAP_ERROR;
+        } else {
+            // TPACKET_V3 only got a send ring in Linux 4.11, without it frames are sent one by one
+            mHasSendRing = setsockopt(mSocket, SOL_PACKET, PACKET_TX_RING, &lSendRequest, sizeof(lSendRequest)) == 0;
+            if (!mHasSendRing) {
+                Logger::GetInstance().Log(std::string("No send ring, sending frames one by one: ") + strerror(errno),
+                                          Logger::Level::WARNING);
+            }
+
+            mRingSize = mReceiveRingSize + (mHasSendRing ? static_cast<size_t>(cSendBlockSize) * cSendBlockCount : 0);
+
+            // Both rings are mapped at once, receive ring first
+            void* lRing{mmap(nullptr, mRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, mSocket, 0)};
+            if (lRing == MAP_FAILED) {
+                lRing = mmap(nullptr, mRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, mSocket, 0);
+            }
+
+            if (lRing == MAP_FAILED) {
+                SetError(std::string("Could not map rings: ") + strerror(errno));
+                lReturn = PCAP_ERROR;
+            } else {
+                mRing = static_cast<uint8_t*>(lRing);
+            }
+        }
+
+        if (lReturn == 0) {
+#ifdef PACKET_IGNORE_OUTGOING
+            // Saves the kernel from copying our own frames into the ring, they get skipped anyway
+            if (mDirection == PcapDirection::DIR_IN) {
+                int lIgnoreOutgoing{1};
+                setsockopt(mSocket, SOL_PACKET, PACKET_IGNORE_OUTGOING, &lIgnoreOutgoing, sizeof(lIgnoreOutgoing));
+            }
+#endif
+            if (bind(mSocket, reinterpret_cast<sockaddr*>(&lAddress), sizeof(lAddress)) != 0) {
+                SetError(std::string("Could not bind to ") + mInterface + ": " + strerror(errno));
+                lReturn = (errno == ENETDOWN) ? PCAP_ERROR_NO_SUCH_DEVICE : PCAP_ERROR;
+            }
+        }
+
+        if (lReturn == 0) {
+            ifreq lRequest{};
+            mInterface.copy(lRequest.ifr_name, sizeof(lRequest.ifr_name) - 1);
+            if (ioctl(mSocket, SIOCGIFHWADDR, &lRequest) == 0) {
+                switch (lRequest.ifr_hwaddr.sa_family) {
+                    case ARPHRD_IEEE80211_RADIOTAP:
+                        mDatalink = DLT_IEEE802_11_RADIO;
+                        break;
+                    case ARPHRD_IEEE80211:
+                        mDatalink = DLT_IEEE802_11;
+                        break;
+                    default:
+                        mDatalink = DLT_EN10MB;
+                        break;
+                }
+            }
+        }
+    }
+
+    if (lReturn != 0 && lReturn != PCAP_ERROR_ACTIVATED) {
+        Logger::GetInstance().Log(mError.data(), Logger::Level::ERROR);
+        Close();
+    }
+
+    return lReturn;
+}
+
+void TPacketWrapper::BreakLoop()
+{
+    mBreakLoop = true;
+
+    if (mBreakEvent >= 0) {
+        eventfd_write(mBreakEvent, 1);
+    }
+}
+
+void TPacketWrapper::Close()
+{
+    if (mRing != nullptr) {
+        munmap(mRing, mRingSize);
+        mRing = nullptr;
+    }
+
+    if (mSocket >= 0) {
+        close(mSocket);
+        mSocket = -1;
+    }
+
+    if (mBreakEvent >= 0) {
+        close(mBreakEvent);
+        mBreakEvent = -1;
+    }
+
+    mCurrentBlock = 0;
+    mBlock        = nullptr;
+    mPacket       = nullptr;
+    mPacketsLeft  = 0;
+    mHasSendRing  = false;
+    mCurrentFrame = 0;
+    mStatistics   = {};
+}
+
+pcap_t* TPacketWrapper::Create(const char* source, char* /*errbuf*/)
+{
+    mInterface = source;
+    return nullptr;
+}
+
+int TPacketWrapper::Dispatch(int cnt, pcap_handler callback, unsigned char* user)
+{
+    int lReturn{0};
+
+    if (IsActivated()) {
+        // Like pcap, wait for the first packets unless in non-blocking mode
+        if (!mNonBlock && mPacketsLeft == 0) {
+            WaitForBlock();
+        }
+
+        // Without a count, stop after reading the whole ring once so a busy link can't keep us here forever
+        const unsigned int lBlocksOpenedStart{mBlocksOpened};
+        tpacket3_hdr*      lPacket{nullptr};
+
+        while (!mBreakLoop && (cnt <= 0 || lReturn < cnt) && (mBlocksOpened - lBlocksOpenedStart) <= mBlockCount &&
+               (lPacket = NextPacket()) != nullptr) {
+            mHeader.ts.tv_sec  = lPacket->tp_sec;
+            mHeader.ts.tv_usec = static_cast<suseconds_t>(lPacket->tp_nsec / 1000);
+            mHeader.caplen     = std::min(lPacket->tp_snaplen, static_cast<uint32_t>(mSnapLen));
+            mHeader.len        = lPacket->tp_len;
+
+            callback(user, &mHeader, reinterpret_cast<unsigned char*>(lPacket) + lPacket->tp_mac);
+            lReturn++;
+        }
+
+        if (mBreakLoop.exchange(false)) {
+            lReturn = PCAP_ERROR_BREAK;
+        }
+    } else {
+        SetError("Dispatch called on a device that has not been activated");
+        lReturn = PCAP_ERROR;
+    }
+
+    return lReturn;
+}
+
+void TPacketWrapper::Dump(unsigned char* user, pcap_pkthdr* header, unsigned char* message)
+{
+    pcap_dump(user, header, message);
+}
+
+void TPacketWrapper::DumpClose(pcap_dumper_t* dumper)
+{
+    pcap_dump_close(dumper);
+}
+
+pcap_dumper_t* TPacketWrapper::DumpOpen(const char* /*outputfile*/)
+{
+    SetError("Dumping is not supported on a TPACKET_V3 capture");
+    return nullptr;
+}
+
+int TPacketWrapper::FindAllDevices(pcap_if_t** alldevicesp, char* errbuf)
+{
+    return pcap_findalldevs(alldevicesp, errbuf);
+}
+
+void TPacketWrapper::FreeAllDevices(pcap_if_t* devices)
+{
+    pcap_freealldevs(devices);
+}
+
+int TPacketWrapper::GetDatalink()
+{
+    return mDatalink;
+}
+
+char* TPacketWrapper::GetError()
+{
+    return mError.data();
+}
+
+int TPacketWrapper::GetSelectableFd()
+{
+    // The socket becomes readable as soon as a block is handed over
+    return mSocket;
+}
+
+int TPacketWrapper::GetStatistics(pcap_stat* stats)
+{
+    int              lReturn{PCAP_ERROR};
+    tpacket_stats_v3 lStatistics{};
+    socklen_t        lLength{sizeof(lStatistics)};
+
+    if (mSocket < 0) {
+        SetError("GetStatistics called on a device that has not been activated");
+    } else if (getsockopt(mSocket, SOL_PACKET, PACKET_STATISTICS, &lStatistics, &lLength) != 0) {
+        SetError(std::string("Could not get statistics: ") + strerror(errno));
+    } else {
+        // The kernel resets its counters on every read, dropped packets are counted as received as well
+        mStatistics.ps_recv += lStatistics.tp_packets;
+        mStatistics.ps_drop += lStatistics.tp_drops;
+        *stats  = mStatistics;
+        lReturn = 0;
+    }
+
+    return lReturn;
+}
+
+bool TPacketWrapper::IsActivated()
+{
+    return mRing != nullptr;
+}
+
+pcap_t* TPacketWrapper::OpenDead(int /*linktype*/, int /*snaplen*/)
+{
+    SetError("Savefiles are not supported on a TPACKET_V3 capture");
+    return nullptr;
+}
+
+pcap_t* TPacketWrapper::OpenOffline(const char* /*fname*/, char* errbuf)
+{
+    SetError("Savefiles are not supported on a TPACKET_V3 capture");
+    if (errbuf != nullptr) {
+        std::strncpy(errbuf, mError.data(), PCAP_ERRBUF_SIZE - 1);
+    }
+    return nullptr;
+}
+
+int TPacketWrapper::NextEx(pcap_pkthdr** header, const unsigned char** pkt_data)
+{
+    int lReturn{0};
+
+    if (IsActivated()) {
+        tpacket3_hdr* lPacket{NextPacket()};
+
+        if (lPacket == nullptr && !mNonBlock) {
+            WaitForBlock();
+            lPacket = NextPacket();
+        }
+
+        if (lPacket != nullptr) {
+            mHeader.ts.tv_sec  = lPacket->tp_sec;
+            mHeader.ts.tv_usec = static_cast<suseconds_t>(lPacket->tp_nsec / 1000);
+            mHeader.caplen     = std::min(lPacket->tp_snaplen, static_cast<uint32_t>(mSnapLen));
+            mHeader.len        = lPacket->tp_len;
+
+            *header   = &mHeader;
+            *pkt_data = reinterpret_cast<unsigned char*>(lPacket) + lPacket->tp_mac;
+            lReturn   = 1;
+        }
+    } else {
+        SetError("NextEx called on a device that has not been activated");
+        lReturn = PCAP_ERROR;
+    }
+
+    return lReturn;
+}
+
+int TPacketWrapper::SendPacket(std::string_view buffer)
+{
+    int lReturn{PCAP_ERROR};
+
+    if (IsActivated()) {
+        if (mHasSendRing) {
+            if (QueueFrame(buffer) && FlushFrames()) {
+                lReturn = 0;
+            }
+        } else if (send(mSocket, buffer.data(), buffer.size(), 0) >= 0) {
+            lReturn = 0;
+        } else {
+            SetError(std::string("Could not send packet: ") + strerror(errno));
+        }
+    }
+
+    return lReturn;
+}
+
+int TPacketWrapper::SendBatch(std::span<const std::string> buffers)
+{
+    int    lSent{0};
+    bool   lFailed{!IsActivated()};
+    size_t lIndex{0};
+
+    while (!lFailed && !mHasSendRing && lIndex < buffers.size()) {
+        if (SendPacket(buffers[lIndex]) == 0) {
+            lIndex++;
+            lSent++;
+        } else {
+            lFailed = true;
+        }
+    }
+
+    while (!lFailed && lIndex < buffers.size()) {
+        // Fill as much of the ring as possible, then let the kernel send all of it in one go
+        int lQueued{0};
+        while (lIndex < buffers.size() && QueueFrame(buffers[lIndex])) {
+            lIndex++;
+            lQueued++;
+        }
+
+        if (lQueued > 0 && FlushFrames()) {
+            lSent += lQueued;
+        } else {
+            lFailed = true;
+        }
+    }
+
+    return lFailed ? -1 : lSent;
+}
+
+int TPacketWrapper::SetBufferSize(int buffer_size)
+{
+    int lReturn{0};
+
+    if (IsActivated()) {
+        lReturn = PCAP_ERROR_ACTIVATED;
+    } else if (buffer_size > 0) {
+        mBlockCount = std::max(1U, (static_cast<unsigned int>(buffer_size) + mBlockSize - 1) / mBlockSize);
+    }
+
+    return lReturn;
+}
+
+int TPacketWrapper::SetDirection(PcapDirection::Direction direction)
+{
+    mDirection = direction;
+    return 0;
+}
+
+int TPacketWrapper::SetFilter(std::string_view filter)
+{
+    int lReturn{PCAP_ERROR};
+
+    if (mSocket >= 0) {
+        // libpcap is only used as a compiler here, its classic BPF instructions are what the kernel expects
+        pcap_t*     lCompiler{pcap_open_dead(mDatalink, mSnapLen)};
+        bpf_program lProgram{};
+
+        if (lCompiler == nullptr) {
+            SetError("Could not create a filter compiler");
+        } else if (pcap_compile(lCompiler, &lProgram, std::string(filter).c_str(), 1, PCAP_NETMASK_UNKNOWN) != 0) {
+            SetError(std::string("Could not compile filter: ") + pcap_geterr(lCompiler));
+        } else {
+            sock_fprog lFilter{};
+            lFilter.len    = static_cast<unsigned short>(lProgram.bf_len);
+            lFilter.filter = reinterpret_cast<sock_filter*>(lProgram.bf_insns);
+
+            if (setsockopt(mSocket, SOL_SOCKET, SO_ATTACH_FILTER, &lFilter, sizeof(lFilter)) == 0) {
+                lReturn = 0;
+            } else {
+                SetError(std::string("Could not attach filter: ") + strerror(errno));
+            }
+
+            pcap_freecode(&lProgram);
+        }
+
+        if (lCompiler != nullptr) {
+            pcap_close(lCompiler);
+        }
+    } else {
+        SetError("SetFilter called on a device that has not been activated");
+    }
+
+    return lReturn;
+}
+
+int TPacketWrapper::SetImmediateMode(int /*mode*/)
+{
+    // Latency is decided by the block timeout given on construction
+    return IsActivated() ? PCAP_ERROR_ACTIVATED : 0;
+}
+
+int TPacketWrapper::SetNonBlock(int nonblock)
+{
+    mNonBlock = (nonblock != 0);
+    return 0;
+}
+
+int TPacketWrapper::SetPassedSources(const std::vector<uint64_t>& /*sources*/)
+{
+    return 0;
+}
+
+int TPacketWrapper::SetSnapLen(int snaplen)
+{
+    int lReturn{PCAP_ERROR_ACTIVATED};
+
+    if (!IsActivated()) {
+        mSnapLen = snaplen > 0 ? snaplen : UINT16_MAX;
+        lReturn  = 0;
+    }
+
+    return lReturn;
+}
+
+int TPacketWrapper::SetTimeOut(int timeout)
+{
+    int lReturn{PCAP_ERROR_ACTIVATED};
+
+    if (!IsActivated()) {
+        mTimeOut = timeout;
+        lReturn  = 0;
+    }
+
+    return lReturn;
+}
+
+tpacket3_hdr* TPacketWrapper::NextPacket()
+{
+    tpacket3_hdr* lReturn{nullptr};
+    bool          lContinue{true};
+
+    while (lContinue) {
+        // The packet handed out last is done with now, so a fully read block can go back to the kernel
+        if (mBlock != nullptr && mPacketsLeft == 0) {
+            ReleaseBlock();
+        }
+
+        if (mBlock != nullptr || OpenBlock()) {
+            tpacket3_hdr* lPacket{mPacket};
+            mPacketsLeft--;
+            if (mPacketsLeft > 0) {
+                mPacket = reinterpret_cast<tpacket3_hdr*>(reinterpret_cast<uint8_t*>(mPacket) +
+                                                          mPacket->tp_next_offset);
+            }
+
+            const auto* lAddress{reinterpret_cast<sockaddr_ll*>(reinterpret_cast<uint8_t*>(lPacket) +
+                                                                TPACKET_ALIGN(sizeof(tpacket3_hdr)))};
+            const bool  lOutgoing{lAddress->sll_pkttype == PACKET_OUTGOING};
+            if ((mDirection == PcapDirection::DIR_INOUT) || (mDirection == PcapDirection::DIR_IN && !lOutgoing) ||
+                (mDirection == PcapDirection::DIR_OUT && lOutgoing)) {
+                lReturn   = lPacket;
+                lContinue = false;
+            }
+        } else {
+            lContinue = false;
+        }
+    }
+
+    return lReturn;
+}
+
+bool TPacketWrapper::OpenBlock()
+{
+    bool lReturn{false};
+
+    auto* lBlock{reinterpret_cast<tpacket_block_desc*>(mRing + static_cast<size_t>(mCurrentBlock) * mBlockSize)};
+
+    if ((LoadStatus(lBlock->hdr.bh1.block_status) & TP_STATUS_USER) != 0U) {
+        mBlock       = lBlock;
+        mPacketsLeft = lBlock->hdr.bh1.num_pkts;
+        mPacket      = reinterpret_cast<tpacket3_hdr*>(reinterpret_cast<uint8_t*>(lBlock) +
+                                                  lBlock->hdr.bh1.offset_to_first_pkt);
+        mBlocksOpened++;
+
+        if (mPacketsLeft == 0) {
+            ReleaseBlock();
+        } else {
+            lReturn = true;
+        }
+    }
+
+    return lReturn;
+}
+
+void TPacketWrapper::ReleaseBlock()
+{
+    StoreStatus(mBlock->hdr.bh1.block_status, TP_STATUS_KERNEL);
+
+    mBlock        = nullptr;
+    mPacket       = nullptr;
+    mPacketsLeft  = 0;
+    mCurrentBlock = (mCurrentBlock + 1) % mBlockCount;
+}
+
+void TPacketWrapper::WaitForBlock()
+{
+    auto* lBlock{reinterpret_cast<tpacket_block_desc*>(mRing + static_cast<size_t>(mCurrentBlock) * mBlockSize)};
+
+    if (!mBreakLoop && (LoadStatus(lBlock->hdr.bh1.block_status) & TP_STATUS_USER) == 0U) {
+        std::array<pollfd, 2> lFileDescriptors{};
+        lFileDescriptors.at(0).fd     = mSocket;
+        lFileDescriptors.at(0).events = POLLIN | POLLERR;
+        lFileDescriptors.at(1).fd     = mBreakEvent;
+        lFileDescriptors.at(1).events = POLLIN;
+
+        // A timeout of 0 means waiting forever, like pcap
+        poll(lFileDescriptors.data(), lFileDescriptors.size(), mTimeOut > 0 ? mTimeOut : -1);
+
+        eventfd_t lWakeUp{0};
+        eventfd_read(mBreakEvent, &lWakeUp);
+    }
+}
+
+bool TPacketWrapper::QueueFrame(std::string_view aData)
+{
+    bool lReturn{false};
+
+    uint8_t* lFrame{mRing + mReceiveRingSize + static_cast<size_t>(mCurrentFrame) * cSendFrameSize};
+    auto*    lHeader{reinterpret_cast<tpacket3_hdr*>(lFrame)};
+
+    if (aData.size() > cSendFrameSize - cSendDataOffset) {
+        SetError("Packet too large for the send ring: " + std::to_string(aData.size()));
+    } else if (const uint32_t lStatus{LoadStatus(lHeader->tp_status)};
+               lStatus != TP_STATUS_AVAILABLE && lStatus != TP_STATUS_WRONG_FORMAT) {
+        // The kernel still owns this one, the caller flushes and comes back
+    } else {
+        std::memcpy(lFrame + cSendDataOffset, aData.data(), aData.size());
+        lHeader->tp_len         = static_cast<uint32_t>(aData.size());
+        lHeader->tp_snaplen     = static_cast<uint32_t>(aData.size());
+        lHeader->tp_next_offset = 0;
+        StoreStatus(lHeader->tp_status, TP_STATUS_SEND_REQUEST);
+
+        mCurrentFrame = (mCurrentFrame + 1) % cSendFrameCount;
+        lReturn       = true;
+    }
+
+    return lReturn;
+}
+
+bool TPacketWrapper::FlushFrames()
+{
+    bool lReturn{true};
+
+    // Blocks until the kernel is done with every frame, so they are all free again afterwards
+    if (send(mSocket, nullptr, 0, 0) < 0) {
+        SetError(std::string("Could not send packets: ") + strerror(errno));
+        lReturn = false;
+    }
+
+    return lReturn;
+}
+
+void TPacketWrapper::SetError(std::string_view aError)
+{
+    const size_t lLength{aError.copy(mError.data(), mError.size() - 1)};
+    mError.at(lLength) = '\0';
+}
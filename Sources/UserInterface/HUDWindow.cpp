@@ -31,6 +31,11 @@ namespace
         return {1, aMaxWidth - static_cast<int>(std::string("Connected to: ").length() + aText.length() + 1), 0, 0};
     }
 
+    Window::Dimensions ScaleCaptureStatistics(const int& aMaxWidth, const std::string& aText)
+    {
+        return {2, aMaxWidth - static_cast<int>(aText.length() + 1), 0, 0};
+    }
+
     Window::Dimensions ScaleEngineStatus(const int& aMaxHeight, const int& aMaxWidth, std::string_view aText)
     {
         return {(aMaxHeight - 1),
@@ -169,6 +174,12 @@ void HUDWindow::SetUp()
         *this, "Hosting", [&] { return ScaleHostingButton(); }, GetModel().mHosting)});
 
     AddObject(CreateQuitText(*this, GetHeightReference()));
+
+    AddObject({std::make_shared<String>(
+        *this,
+        GetModel().mCaptureStatistics,
+        [&] { return ScaleCaptureStatistics(GetWidthReference(), GetModel().mCaptureStatistics); },
+        !GetModel().mCaptureStatistics.empty())});
 }
 
 void HUDWindow::Draw()
@@ -203,6 +214,14 @@ void HUDWindow::Draw()
         GetObjects().at(1)->Scale();
     }
 
+    if (mOldCaptureStatistics != GetModel().mCaptureStatistics) {
+        ClearLine(2, 1, GetWidthReference() - 1);
+        mOldCaptureStatistics = GetModel().mCaptureStatistics;
+        GetObjects().at(8)->SetVisible(!GetModel().mCaptureStatistics.empty());
+        GetObjects().at(8)->SetName(GetModel().mCaptureStatistics);
+        GetObjects().at(8)->Scale();
+    }
+
     if (mOldHosting != GetModel().mHosting) {
         mOldHosting = GetModel().mHosting;
         // Tell the engine to start broadcasting ssids
@@ -23,6 +23,19 @@ static ConnectionMethod ConvertConnectionMethodText(std::string_view aLevel)
     return lReturn;
 }
 
+static CaptureBackend ConvertCaptureBackendText(std::string_view aBackend)
+{
+    CaptureBackend lReturn{cDefaultCaptureBackend};
+
+    for (std::size_t lCount = 0; lCount < cCaptureBackendTexts.size(); lCount++) {
+        if (cCaptureBackendTexts.at(lCount) == aBackend) {
+            lReturn = static_cast<CaptureBackend>(lCount);
+        }
+    }
+
+    return lReturn;
+}
+
 static bool StringToBool(std::string_view aString)
 {
     bool lReturn{false};
@@ -44,12 +57,16 @@ bool WindowModel::SaveToFile(std::string_view aPath) const
         lFile << cSaveAcknowledgeDataFrames << ": " << BoolToString(mAcknowledgeDataFrames) << std::endl;
         lFile << cSaveAutoDiscoverPSPVita << ": " << BoolToString(mAutoDiscoverPSPVitaNetworks) << std::endl;
         lFile << cSaveAutoDiscoverXLinkKai << ": " << BoolToString(mAutoDiscoverXLinkKaiInstance) << std::endl;
+        lFile << cSaveCaptureBackend << ": \"" << cCaptureBackendTexts.at(mCaptureBackend) << "\"" << std::endl;
+        lFile << cSaveCaptureBufferSizeKiB << ": \"" << mCaptureBufferSizeKiB << "\"" << std::endl;
         lFile << cSaveChannel << ": \"" << mChannel << "\"" << std::endl;
         lFile << cSaveConnectionMethod << ": \"" << cConnectionMethodTexts.at(mConnectionMethod) << "\"" << std::endl;
         lFile << cSaveLogLevel << ": \"" << Logger::ConvertLogLevelToString(mLogLevel) << "\"" << std::endl;
         lFile << cSaveOnlyAcceptFromMac << ": \"" << mOnlyAcceptFromMac << "\"" << std::endl;
         lFile << cSaveReConnectionTimeOutS << ": \"" << mReConnectionTimeOutS << "\"" << std::endl;
         lFile << cSaveTheme << ": \"" << mTheme << "\"" << std::endl;
+        lFile << cSaveTPacketBlockSizeKiB << ": \"" << mTPacketBlockSizeKiB << "\"" << std::endl;
+        lFile << cSaveTPacketTimeOutMs << ": \"" << mTPacketTimeOutMs << "\"" << std::endl;
         lFile << cSaveUseSSIDFromHost << ": " << BoolToString(mUseSSIDFromHost) << std::endl;
         lFile << cSaveUseSSIDFromXLinkKai << ": " << BoolToString(mUseSSIDFromXLinkKai) << std::endl;
         lFile << cSaveUseXLinkKaiHints << ": " << BoolToString(mUseXLinkKaiHints) << std::endl;
@@ -97,6 +114,10 @@ bool WindowModel::LoadFromFile(std::string_view aPath)
                             mAutoDiscoverPSPVitaNetworks = StringToBool(lResult);
                         } else if (lOption == cSaveAutoDiscoverXLinkKai) {
                             mAutoDiscoverXLinkKaiInstance = StringToBool(lResult);
+                        } else if (lOption == cSaveCaptureBackend) {
+                            mCaptureBackend = ConvertCaptureBackendText(lResult.substr(1, lResult.size() - 2));
+                        } else if (lOption == cSaveCaptureBufferSizeKiB) {
+                            mCaptureBufferSizeKiB = lResult.substr(1, lResult.size() - 2);
                         } else if (lOption == cSaveChannel) {
                             mChannel = lResult.substr(1, lResult.size() - 2);
                         } else if (lOption == cSaveConnectionMethod) {
@@ -109,6 +130,10 @@ bool WindowModel::LoadFromFile(std::string_view aPath)
                             mReConnectionTimeOutS = lResult.substr(1, lResult.size() - 2);
                         } else if (lOption == cSaveTheme) {
                             mTheme = lResult.substr(1, lResult.size() - 2);
+                        } else if (lOption == cSaveTPacketBlockSizeKiB) {
+                            mTPacketBlockSizeKiB = lResult.substr(1, lResult.size() - 2);
+                        } else if (lOption == cSaveTPacketTimeOutMs) {
+                            mTPacketTimeOutMs = lResult.substr(1, lResult.size() - 2);
                         } else if (lOption == cSaveUseSSIDFromHost) {
                             mUseSSIDFromHost = StringToBool(lResult);
                         } else if (lOption == cSaveUseSSIDFromXLinkKai) {
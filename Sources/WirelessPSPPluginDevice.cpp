@@ -5,6 +5,7 @@
 #include <chrono>
 #include <string>
 
+#include "LatencyStatistics.h"
 #include "NetConversionFunctions.h"
 
 using namespace std::chrono;
@@ -31,7 +32,7 @@ bool WirelessPSPPluginDevice::ReadCallback(const unsigned char* aData, const pca
     bool lReturn{false};
 
     // Load all needed information into the handler
-    std::string lData{DataToString(aData, aHeader)};
+    std::string_view lData{DataToStringView(aData, aHeader)};
     mPacketHandler->Update(lData);
 
     if (!mPacketHandler->GetBlackList().IsMacBlackListed(mPacketHandler->GetSourceMac())) {
@@ -42,22 +43,30 @@ bool WirelessPSPPluginDevice::ReadCallback(const unsigned char* aData, const pca
             std::string lPacket{ConstructPSPPluginHandshake(mPacketHandler->GetSourceMac(), GetAdapterMacAddress())};
 
             // Log
-            Logger::GetInstance().Log("Sending: " + PrettyHexString(lPacket), Logger::Level::TRACE);
+            if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                Logger::GetInstance().Log("Sending: " + PrettyHexString(lPacket), Logger::Level::TRACE);
+            }
 
             Send(lPacket, false);
         } else if (mPacketHandler->GetEtherType() == Net_Constants::cPSPEtherType) {
             // Log
-            Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+            if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+            }
 
             // Reset the timer so it will not time out
             GetReadWatchdog() = std::chrono::system_clock::now();
 
             // From plugin mode -> 802.3
-            lData = mPacketHandler->ConvertPacketOut();
-            GetConnector()->Send(lData);
+            const std::string_view lPacket{mPacketHandler->ConvertPacketOut()};
+            LatencyStatistics::GetInstance().Record(
+                LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Converted, aHeader);
 
+            // Set before sending, the connector reads the capture time from the header
             SetData(aData);
             SetHeader(aHeader);
+            GetConnector()->Send(lPacket);
+
             IncreasePacketCount();
         }
     }
@@ -67,9 +76,33 @@ bool WirelessPSPPluginDevice::ReadCallback(const unsigned char* aData, const pca
 
 void WirelessPSPPluginDevice::BlackList(uint64_t aMac)
 {
+    // XLink Kai hands over the source of every packet it sends, only rebuild the filter for new ones
+    if (mPacketHandler != nullptr && mPacketHandler->GetBlackList().AddToMacBlackList(aMac)) {
+        RequestFilterUpdate();
+    }
+}
+
+std::string WirelessPSPPluginDevice::BuildFilter()
+{
+    std::string lReturn{};
+
+    if (mPacketHandler != nullptr) {
+        lReturn = ConstructEthernetFilter({Net_Constants::cPSPEtherType},
+                                          mPacketHandler->GetBlackList().GetMacBlackList());
+    }
+
+    return lReturn;
+}
+
+std::vector<uint64_t> WirelessPSPPluginDevice::BuildPassedSources()
+{
+    std::vector<uint64_t> lReturn{};
+
     if (mPacketHandler != nullptr) {
-        mPacketHandler->GetBlackList().AddToMacBlackList(aMac);
+        lReturn = mPacketHandler->GetBlackList().GetMacBlackList();
     }
+
+    return lReturn;
 }
 
 bool WirelessPSPPluginDevice::Send(std::string_view aData)
@@ -78,24 +111,35 @@ bool WirelessPSPPluginDevice::Send(std::string_view aData)
 }
 
 bool WirelessPSPPluginDevice::Send(std::string_view aData, bool aModifyData)
+{
+    return Queue(aData, aModifyData) && Flush();
+}
+
+bool WirelessPSPPluginDevice::Queue(std::string_view aData)
+{
+    return Queue(aData, true);
+}
+
+bool WirelessPSPPluginDevice::Queue(std::string_view aData, bool aModifyData)
 {
     bool lReturn{false};
     if (GetWrapper()->IsActivated()) {
         if (!aData.empty()) {
-            std::string lData{aData.data(), aData.size()};
+            std::string_view lData{aData};
 
             if (aModifyData) {
                 // Convert 8023 -> PSP Plugin
-                lData = mPacketHandler->ConvertPacketIn(lData, GetAdapterMacAddress());
+                lData = mPacketHandler->ConvertPacketIn(aData, GetAdapterMacAddress());
             }
 
-            Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(lData), Logger::Level::TRACE);
+            // Never queue an empty frame, it would make the whole batch fail
+            if (!lData.empty()) {
+                if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                    Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(lData), Logger::Level::TRACE);
+                }
 
-            if (GetWrapper()->SendPacket(lData) == 0) {
+                AddToSendQueue(lData);
                 lReturn = true;
-            } else {
-                Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(GetWrapper()->GetError()),
-                                          Logger::Level::ERROR);
             }
         }
     } else {
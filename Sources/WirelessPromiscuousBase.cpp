@@ -2,12 +2,21 @@
 
 #include "WirelessPromiscuousBase.h"
 
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <thread>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 #include "NetConversionFunctions.h"
+#include "Reactor.h"
 #include "XLinkKaiConnection.h"
 
 using namespace std::chrono;
@@ -54,10 +63,13 @@ bool WirelessPromiscuousBase::Open(std::string_view                aName,
     mWrapper->SetTimeOut(cPCAPTimeoutMs);
     mWrapper->SetDirection(PcapDirection::DIR_IN);
     mWrapper->SetImmediateMode(1);
+    SetUpCaptureBuffer(*mWrapper);
 
     int lStatus{mWrapper->Activate()};
     if (lStatus == 0) {
         mConnected = true;
+        RequestFilterUpdate();
+        UpdateFilter(*mWrapper);
     } else {
         lReturn = false;
         Logger::GetInstance().Log("pcap_activate failed, " + std::string(pcap_statustostr(lStatus)),
@@ -81,6 +93,12 @@ void WirelessPromiscuousBase::Close()
 
     mWrapper->BreakLoop();
 
+#ifdef __linux__
+    if (mStopEvent >= 0) {
+        eventfd_write(mStopEvent, 1);
+    }
+#endif
+
     if (mReceiverThread != nullptr) {
         while (!mReceiverThread->joinable()) {
             // Wait
@@ -90,6 +108,13 @@ void WirelessPromiscuousBase::Close()
         mReceiverThread->join();
     }
 
+#ifdef __linux__
+    if (mStopEvent >= 0) {
+        close(mStopEvent);
+        mStopEvent = -1;
+    }
+#endif
+
     if (mAutoConnect && mWifiTimeoutThread != nullptr) {
         while (!mWifiTimeoutThread->joinable()) {
             // Wait
@@ -99,6 +124,7 @@ void WirelessPromiscuousBase::Close()
         mWifiTimeoutThread->join();
     }
 
+    CollectStatistics(*mWrapper, Logger::Level::INFO);
     mWrapper->Close();
 
     mWrapper = nullptr;
@@ -196,32 +222,177 @@ std::chrono::time_point<std::chrono::system_clock>& WirelessPromiscuousBase::Get
     return mReadWatchdog;
 }
 
+bool WirelessPromiscuousBase::Flush()
+{
+    return FlushSendQueue(*mWrapper);
+}
+
 std::shared_ptr<IPCapWrapper>& WirelessPromiscuousBase::GetWrapper()
 {
     return mWrapper;
 }
 
+void WirelessPromiscuousBase::CheckReadWatchdog()
+{
+    if (!mPausedAutoConnect && std::chrono::system_clock::now() > (mReadWatchdog + mReConnectionTimeOut)) {
+        Logger::GetInstance().Log("Switching networks due to timeout!", Logger::Level::DEBUG);
+        // Read timed out try to connect to another network.
+        Connect();
+        mReadWatchdog = std::chrono::system_clock::now();
+    }
+}
+
+void WirelessPromiscuousBase::StartWatchdogThread()
+{
+    if (mAutoConnect && mWifiTimeoutThread == nullptr && mReConnectionTimeOut.count() > 0) {
+        mWifiTimeoutThread = std::make_shared<std::thread>([&] {
+            while (mConnected) {
+                CheckReadWatchdog();
+                std::this_thread::sleep_for(1s);
+            }
+        });
+    }
+}
+
+void WirelessPromiscuousBase::DispatchReady()
+{
+    auto lCallbackFunction = [](unsigned char* aThis, const pcap_pkthdr* aHeader, const unsigned char* aPacket) {
+        auto* lThis = reinterpret_cast<WirelessPromiscuousBase*>(aThis);
+        lThis->ReadCallback(aPacket, aHeader);
+    };
+
+    if (mWrapper->Dispatch(-1, lCallbackFunction, reinterpret_cast<u_char*>(this)) == -1) {
+        Logger::GetInstance().Log("Error occurred while reading packet: " + std::string(mWrapper->GetError()),
+                                  Logger::Level::DEBUG);
+    }
+
+    UpdateFilter(*mWrapper);
+    UpdateStatistics(*mWrapper);
+}
+
+#ifdef __linux__
+int WirelessPromiscuousBase::SetUpEvents(int aSelectableFd)
+{
+    int lReturn{epoll_create1(EPOLL_CLOEXEC)};
+
+    if (lReturn >= 0) {
+        epoll_event lEvent{};
+        lEvent.events  = EPOLLIN;
+        lEvent.data.fd = aSelectableFd;
+        bool lAdded{epoll_ctl(lReturn, EPOLL_CTL_ADD, aSelectableFd, &lEvent) == 0};
+        lEvent.data.fd = mStopEvent;
+        lAdded         = lAdded && epoll_ctl(lReturn, EPOLL_CTL_ADD, mStopEvent, &lEvent) == 0;
+
+        if (!lAdded) {
+            Logger::GetInstance().Log(std::string("Could not wait on the capture, ") + strerror(errno),
+                                      Logger::Level::WARNING);
+            close(lReturn);
+            lReturn = -1;
+        }
+    } else {
+        Logger::GetInstance().Log(std::string("Could not create epoll instance, ") + strerror(errno),
+                                  Logger::Level::WARNING);
+    }
+
+    return lReturn;
+}
+
+void WirelessPromiscuousBase::ReceiveEvents(int aEpoll, int aSelectableFd)
+{
+    const bool lUseWatchdog{mAutoConnect && mReConnectionTimeOut.count() > 0};
+
+    // Only dispatch what is ready, never wait inside pcap
+    mWrapper->SetNonBlock(1);
+
+    std::array<epoll_event, 2> lEvents{};
+    while (mConnected && (mWrapper->IsActivated())) {
+        // Without a watchdog there is nothing to do until a packet arrives or the device gets closed, otherwise wake up
+        // when the read watchdog runs out. While a reconnect is going on elsewhere, check again every second.
+        int lTimeout{-1};
+        if (lUseWatchdog) {
+            const auto lLeft{duration_cast<milliseconds>(mReadWatchdog + mReConnectionTimeOut - system_clock::now())};
+            lTimeout = static_cast<int>(lLeft.count() > 0 ? lLeft.count() + 1 : milliseconds(1s).count());
+        }
+
+        int lAmount{epoll_wait(aEpoll, lEvents.data(), lEvents.size(), lTimeout)};
+
+        for (int lCount = 0; lCount < lAmount; lCount++) {
+            if (lEvents.at(lCount).data.fd == aSelectableFd && mConnected) {
+                DispatchReady();
+            }
+        }
+
+        // Packets from other networks don't reset the watchdog, so it can run out while packets keep arriving
+        if (lUseWatchdog && mConnected) {
+            CheckReadWatchdog();
+        }
+    }
+
+    close(aEpoll);
+}
+#endif
+
+bool WirelessPromiscuousBase::AddToReactor(std::shared_ptr<Reactor> aReactor)
+{
+    bool lReturn{false};
+
+    if (mWrapper->IsActivated() && mReceiverThread == nullptr) {
+        const int lSelectableFd{mWrapper->GetSelectableFd()};
+        if (lSelectableFd >= 0) {
+            // Only dispatch what is ready, never wait inside pcap
+            mWrapper->SetNonBlock(1);
+            mReadWatchdog = std::chrono::system_clock::now();
+
+            lReturn = aReactor->AddReadable(lSelectableFd, [&] { DispatchReady(); });
+
+            // Reconnecting blocks while scanning, that can't happen on the reactor thread
+            if (lReturn) {
+                StartWatchdogThread();
+            }
+        } else {
+            Logger::GetInstance().Log("Device can't be waited on, can't add it to a reactor", Logger::Level::ERROR);
+        }
+    } else {
+        Logger::GetInstance().Log("Can't add to reactor without a handler!", Logger::Level::ERROR);
+    }
+
+    return lReturn;
+}
+
 bool WirelessPromiscuousBase::StartReceiverThread()
 {
     bool lReturn{true};
 
     if (mWrapper->IsActivated()) {
         // Run
+#ifdef __linux__
+        // Wait for packets event driven where pcap allows it, otherwise fall back to polling below
         if (mReceiverThread == nullptr) {
-            if (mAutoConnect && mWifiTimeoutThread == nullptr && mReConnectionTimeOut.count() > 0) {
-                mWifiTimeoutThread = std::make_shared<std::thread>([&] {
-                    while (mConnected) {
-                        if (!mPausedAutoConnect &&
-                            std::chrono::system_clock::now() > (mReadWatchdog + mReConnectionTimeOut)) {
-                            Logger::GetInstance().Log("Switching networks due to timeout!", Logger::Level::DEBUG);
-                            // Read timed out try to connect to another network.
-                            Connect();
-                            mReadWatchdog = std::chrono::system_clock::now();
-                        }
-                        std::this_thread::sleep_for(1s);
-                    }
-                });
+            const int lSelectableFd{mWrapper->GetSelectableFd()};
+            if (lSelectableFd >= 0) {
+                mStopEvent = eventfd(0, EFD_CLOEXEC);
+                const int lEpoll{mStopEvent >= 0 ? SetUpEvents(lSelectableFd) : -1};
+                if (lEpoll >= 0) {
+                    mReceiverThread = std::make_shared<std::thread>([this, lEpoll, lSelectableFd] {
+                        // If we're receiving data from the receiver thread, send it off as well.
+                        bool lSendReceivedDataOld = mSendReceivedData;
+                        mSendReceivedData         = true;
+                        mReadWatchdog             = std::chrono::system_clock::now();
+
+                        ReceiveEvents(lEpoll, lSelectableFd);
+
+                        mSendReceivedData = lSendReceivedDataOld;
+                    });
+                } else if (mStopEvent >= 0) {
+                    close(mStopEvent);
+                    mStopEvent = -1;
+                }
             }
+        }
+#endif
+
+        if (mReceiverThread == nullptr) {
+            StartWatchdogThread();
 
             mReceiverThread = std::make_shared<std::thread>([&] {
                 // If we're receiving data from the receiver thread, send it off as well.
@@ -243,6 +414,8 @@ bool WirelessPromiscuousBase::StartReceiverThread()
                             "Error occurred while reading packet: " + std::string(mWrapper->GetError()),
                             Logger::Level::DEBUG);
                     }
+                    UpdateFilter(*mWrapper);
+                    UpdateStatistics(*mWrapper);
                     std::this_thread::sleep_for(100us);
                 }
 
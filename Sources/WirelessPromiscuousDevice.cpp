@@ -5,6 +5,7 @@
 #include <chrono>
 #include <string>
 
+#include "LatencyStatistics.h"
 #include "NetConversionFunctions.h"
 
 using namespace std::chrono;
@@ -31,20 +32,26 @@ bool WirelessPromiscuousDevice::ReadCallback(const unsigned char* aData, const p
     bool lReturn{false};
 
     // Load all needed information into the handler
-    std::string lData{DataToString(aData, aHeader)};
+    std::string_view lData{DataToStringView(aData, aHeader)};
     mPacketHandler->Update(lData);
 
     if (!mPacketHandler->GetBlackList().IsMacBlackListed(mPacketHandler->GetSourceMac())) {
         // Log
-        Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+            Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        }
 
         // Reset the timer so it will not time out
         GetReadWatchdog() = std::chrono::system_clock::now();
 
-        GetConnector()->Send(lData);
+        LatencyStatistics::GetInstance().Record(
+            LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Converted, aHeader);
 
+        // Set before sending, the connector reads the capture time from the header
         SetData(aData);
         SetHeader(aHeader);
+        GetConnector()->Send(lData);
+
         IncreasePacketCount();
     }
 
@@ -53,47 +60,73 @@ bool WirelessPromiscuousDevice::ReadCallback(const unsigned char* aData, const p
 
 void WirelessPromiscuousDevice::BlackList(uint64_t aMac)
 {
+    // XLink Kai hands over the source of every packet it sends, only rebuild the filter for new ones
+    if (mPacketHandler != nullptr && mPacketHandler->GetBlackList().AddToMacBlackList(aMac)) {
+        RequestFilterUpdate();
+    }
+}
+
+std::string WirelessPromiscuousDevice::BuildFilter()
+{
+    std::string lReturn{};
+
+    if (mPacketHandler != nullptr) {
+        lReturn = ConstructEthernetFilter({}, mPacketHandler->GetBlackList().GetMacBlackList());
+    }
+
+    return lReturn;
+}
+
+std::vector<uint64_t> WirelessPromiscuousDevice::BuildPassedSources()
+{
+    std::vector<uint64_t> lReturn{};
+
     if (mPacketHandler != nullptr) {
-        mPacketHandler->GetBlackList().AddToMacBlackList(aMac);
+        lReturn = mPacketHandler->GetBlackList().GetMacBlackList();
     }
+
+    return lReturn;
 }
 
 bool WirelessPromiscuousDevice::Send(std::string_view aData)
+{
+    return Queue(aData) && Flush();
+}
+
+bool WirelessPromiscuousDevice::Queue(std::string_view aData)
 {
     bool lReturn{false};
     if (GetWrapper()->IsActivated()) {
         if (!aData.empty()) {
-            std::string lData{aData.data(), aData.size()};
-
-            // If we got our specific DDS Mac Address, replace it by the one from our adapter.
-            if ((GetRawData<uint64_t>(lData.data(), Net_8023_Constants::cSourceAddressIndex) &
-                 Net_Constants::cBroadcastMac) == Net_Constants::cDDSReplaceMac) {
-                uint64_t lAdapterMacAddress = GetAdapterMacAddress();
-                memcpy(lData.data() + Net_8023_Constants::cSourceAddressIndex,
-                       &lAdapterMacAddress,
-                       Net_8023_Constants::cSourceAddressLength);
-
-                // Check if we are an ARP-Something
-                if (GetRawData<uint16_t>(lData.data(), Net_8023_Constants::cEtherTypeIndex) ==
-                    Net_Constants::Arp::cEtherType) {
-                    auto lOpCode = GetRawData<uint16_t>(lData.data(), Net_Constants::Arp::cOpCodeIndex);
-                    if (lOpCode == Net_Constants::Arp::cOpCodeRequest || lOpCode == Net_Constants::Arp::cOpCodeReply) {
-                        // This would also contain the XLink Kai VRRP Mac
-                        memcpy(lData.data() + Net_Constants::Arp::cSenderMacIndex,
-                               &lAdapterMacAddress,
-                               Net_Constants::cMacAddressLength);
+            // Patched in the queued copy, so there is no buffer to allocate for every packet
+            AddToSendQueue(aData, [this](std::string& aPacket) {
+                // If we got our specific DDS Mac Address, replace it by the one from our adapter.
+                if ((GetRawData<uint64_t>(aPacket.data(), Net_8023_Constants::cSourceAddressIndex) &
+                     Net_Constants::cBroadcastMac) == Net_Constants::cDDSReplaceMac) {
+                    uint64_t lAdapterMacAddress = GetAdapterMacAddress();
+                    memcpy(aPacket.data() + Net_8023_Constants::cSourceAddressIndex,
+                           &lAdapterMacAddress,
+                           Net_8023_Constants::cSourceAddressLength);
+
+                    // Check if we are an ARP-Something
+                    if (GetRawData<uint16_t>(aPacket.data(), Net_8023_Constants::cEtherTypeIndex) ==
+                        Net_Constants::Arp::cEtherType) {
+                        auto lOpCode = GetRawData<uint16_t>(aPacket.data(), Net_Constants::Arp::cOpCodeIndex);
+                        if (lOpCode == Net_Constants::Arp::cOpCodeRequest ||
+                            lOpCode == Net_Constants::Arp::cOpCodeReply) {
+                            // This would also contain the XLink Kai VRRP Mac
+                            memcpy(aPacket.data() + Net_Constants::Arp::cSenderMacIndex,
+                                   &lAdapterMacAddress,
+                                   Net_Constants::cMacAddressLength);
+                        }
                     }
                 }
-            }
-
-            Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(lData), Logger::Level::TRACE);
 
-            if (GetWrapper()->SendPacket(lData) == 0) {
-                lReturn = true;
-            } else {
-                Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(GetWrapper()->GetError()),
-                                          Logger::Level::ERROR);
-            }
+                if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                    Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(aPacket), Logger::Level::TRACE);
+                }
+            });
+            lReturn = true;
         }
     } else {
         Logger::GetInstance().Log("Cannot send packets on a device that has not been opened yet!",
@@ -2,6 +2,7 @@
 
 #include "XLinkKaiConnection.h"
 
+#include <array>
 #include <chrono>
 #include <cstring>
 #include <iostream>
@@ -11,6 +12,7 @@
 #include <boost/exception/diagnostic_information.hpp>
 
 #include "IPCapDevice.h"
+#include "LatencyStatistics.h"
 #include "Logger.h"
 #include "MonitorDevice.h"
 #include "NetConversionFunctions.h"
@@ -48,6 +50,10 @@ bool XLinkKaiConnection::Open(std::string_view aIp, unsigned int aPort)
         mSocket.open(ip::udp::v4());
         mIp   = aIp;
         mPort = aPort;
+
+        if (mReactor != nullptr) {
+            lReturn = AddSocketToReactor();
+        }
     } catch (const boost::system::system_error& lException) {
         Logger::GetInstance().Log("Failed to open socket: " + std::string(lException.what()), Logger::Level::ERROR);
         lReturn = false;
@@ -80,13 +86,19 @@ bool XLinkKaiConnection::Send(std::string_view aCommand, std::string_view aData)
         if ((mConnected || aCommand == cConnectString || aCommand == cDisconnectString)) {
             try {
                 if (aCommand == cEthernetDataString) {
-                    Logger::GetInstance().Log("Sent: " + std::string(aCommand) + PrettyHexString(aData),
-                                              Logger::Level::TRACE);
+                    if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                        Logger::GetInstance().Log("Sent: " + std::string(aCommand) + PrettyHexString(aData),
+                                                  Logger::Level::TRACE);
+                    }
                 } else {
                     Logger::GetInstance().Log("Sent: " + std::string(aCommand) + aData.data(), Logger::Level::DEBUG);
                 }
 
-                mSocket.send_to(buffer(std::string(aCommand) + std::string(aData)), mRemote);
+                // Send command and data as one datagram straight from their own buffers (gather I/O), so
+                // nothing needs to be concatenated and allocated per packet.
+                const std::array<const_buffer, 2> lBuffers{buffer(aCommand.data(), aCommand.size()),
+                                                           buffer(aData.data(), aData.size())};
+                mSocket.send_to(lBuffers, mRemote);
             } catch (const boost::system::system_error& lException) {
                 Logger::GetInstance().Log(
                     "Could not send message! " + std::string(aData) + std::string(lException.what()),
@@ -107,7 +119,67 @@ bool XLinkKaiConnection::Send(std::string_view aCommand, std::string_view aData)
 
 bool XLinkKaiConnection::Send(std::string_view aData)
 {
-    return Send(cEthernetDataString, aData);
+    bool lReturn{false};
+
+    if (mUseSendRing.load(std::memory_order_acquire)) {
+        if (mConnected) {
+            lReturn = mSendRing.Push(aData, GetCaptureArrival());
+            if (!lReturn && !aData.empty()) {
+                Logger::GetInstance().Log("Send ring full, dropped packet! Dropped so far: " +
+                                              std::to_string(mSendRing.GetDroppedCount()),
+                                          Logger::Level::DEBUG);
+            }
+        } else {
+            Logger::GetInstance().Log("No other messages before Xlink Kai has connected!", Logger::Level::DEBUG);
+        }
+    } else {
+        const std::chrono::system_clock::time_point lArrival{GetCaptureArrival()};
+        lReturn = Send(cEthernetDataString, aData);
+        if (lReturn) {
+            LatencyStatistics::GetInstance().Record(
+                LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Sent, lArrival);
+        }
+    }
+
+    return lReturn;
+}
+
+std::chrono::system_clock::time_point XLinkKaiConnection::GetCaptureArrival()
+{
+    std::chrono::system_clock::time_point lReturn{};
+
+    // Send is called from the receive callback of the device, so its header still belongs to this packet
+    if (LatencyStatistics::GetInstance().IsEnabled() && mIncomingConnection != nullptr &&
+        mIncomingConnection->GetHeader() != nullptr) {
+        lReturn = LatencyStatistics::GetArrival(*mIncomingConnection->GetHeader());
+    }
+
+    return lReturn;
+}
+
+void XLinkKaiConnection::StartSenderThread()
+{
+    if (mSenderThread == nullptr) {
+        mSenderRunning = true;
+        mSenderThread  = std::make_shared<std::thread>([&] {
+            while (mSenderRunning) {
+                std::string_view lData{mSendRing.Front()};
+                if (!lData.empty()) {
+                    if (Send(cEthernetDataString, lData)) {
+                        LatencyStatistics::GetInstance().Record(LatencyStatistics_Constants::ToXLinkKai,
+                                                                LatencyStatistics_Constants::Sent,
+                                                                mSendRing.FrontArrival());
+                    }
+                    mSendRing.Pop();
+                } else {
+                    mSendRing.Wait();
+                }
+            }
+        });
+
+        // Only hand packets to the ring once there is a thread to take them off
+        mUseSendRing.store(true, std::memory_order_release);
+    }
 }
 
 bool XLinkKaiConnection::HandleKeepAlive()
@@ -135,127 +207,210 @@ bool XLinkKaiConnection::ReadNextData()
 
 void XLinkKaiConnection::ReceiveCallback(const boost::system::error_code& /*aError*/, size_t aBytesReceived)
 {
-    std::string lData{mData.begin(), mData.begin() + aBytesReceived};
+    const std::chrono::system_clock::time_point lArrival{std::chrono::system_clock::now()};
 
-    // If we actually received anything useful, react.
-    if (!lData.empty()) {
-        // Make sure the keepalive timer gets tickled so it doesn't bite.
-        mKeepAliveTimerStart += (std::chrono::system_clock::now() - mKeepAliveTimerStart);
-        std::size_t lFirstSeparator{lData.find(cSeparator)};
-        std::string lCommand{lData.substr(0, lFirstSeparator + 1)};
+    HandleReceivedData({mData.data(), aBytesReceived}, lArrival);
+    FlushIncomingConnection(lArrival);
+
+    StartReceiverThread();
+}
 
-        if (lCommand != std::string(cEthernetDataFormat) + cSeparator.data()) {
-            Logger::GetInstance().Log("Received: " + lCommand + lData, Logger::Level::TRACE);
+#ifdef __linux__
+void XLinkKaiConnection::ReceiveBatchCallback(const boost::system::error_code& aError)
+{
+    if (!aError) {
+        ReceiveBatch();
+    }
+
+    StartReceiverThread();
+}
+
+void XLinkKaiConnection::ReceiveBatch()
+{
+    int lAmountReceived{0};
+    do {
+        for (unsigned int lCount = 0; lCount < cReceiveBatchSize; lCount++) {
+            // The kernel overwrites the lengths, so these have to be reset before every call
+            mmsghdr& lHeader{mBatchHeaders.at(lCount)};
+            mBatchVectors.at(lCount)    = {mBatchData.at(lCount).data(), cMaxLength};
+            lHeader                     = {};
+            lHeader.msg_hdr.msg_name    = &mBatchAddresses.at(lCount);
+            lHeader.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            lHeader.msg_hdr.msg_iov     = &mBatchVectors.at(lCount);
+            lHeader.msg_hdr.msg_iovlen  = 1;
         }
 
-        if (!mConnected && (lCommand == std::string(cConnectedFormat) + cSeparator.data())) {
-            lCommand = lData.substr(0, cConnectedString.size());
-            if (lCommand == cConnectedString) {
-                Logger::GetInstance().Log("XLink Kai succesfully connected: " + lCommand, Logger::Level::INFO);
-                mConnectInitiated = false;
-                mConnected        = true;
+        lAmountReceived =
+            recvmmsg(mSocket.native_handle(), mBatchHeaders.data(), cReceiveBatchSize, MSG_DONTWAIT, nullptr);
+        const std::chrono::system_clock::time_point lArrival{std::chrono::system_clock::now()};
+
+        for (int lCount = 0; lCount < lAmountReceived; lCount++) {
+            const mmsghdr& lHeader{mBatchHeaders.at(lCount)};
+            if (lHeader.msg_hdr.msg_namelen <= mRemote.capacity()) {
+                std::memcpy(mRemote.data(), &mBatchAddresses.at(lCount), lHeader.msg_hdr.msg_namelen);
+                mRemote.resize(lHeader.msg_hdr.msg_namelen);
             }
+            HandleReceivedData({mBatchData.at(lCount).data(), lHeader.msg_len}, lArrival);
         }
 
-        // If no connection confirmation has been sent on XLink Kai's side, Don't care about any other message yet
-        if (mConnected) {
-            if (lCommand == cKeepAliveString) {
-                HandleKeepAlive();
-            } else if (lCommand == std::string(cEthernetDataFormat) + cSeparator.data()) {
-                // For data XLink Kai uses e;e; which doesn't filter all that well, so if we find e; just check if this
-                // is e;e;
-                lCommand = lData.substr(0, cEthernetDataString.size());
+        // Inject everything this batch produced in one go
+        FlushIncomingConnection(lArrival);
+        // A full batch means there may be more waiting
+    } while (lAmountReceived == static_cast<int>(cReceiveBatchSize) && mSocket.is_open());
+}
+#endif
 
-                Logger::GetInstance().Log("Received: " + PrettyHexString(lData.substr(cEthernetDataString.length())),
-                                          Logger::Level::TRACE);
+void XLinkKaiConnection::FlushIncomingConnection(std::chrono::system_clock::time_point aArrival)
+{
+    if (mIncomingConnection != nullptr && mIncomingConnection->Flush()) {
+        LatencyStatistics::GetInstance().Record(
+            LatencyStatistics_Constants::ToDevice, LatencyStatistics_Constants::Sent, aArrival, mQueuedPackets);
+    }
 
-                if (lCommand == cEthernetDataString) {
-                    if (mIncomingConnection != nullptr) {
-                        // Strip e;e;
-                        mEthernetData =
-                            lData.substr(cEthernetDataString.length(), lData.length() - cEthernetDataString.length());
+    mQueuedPackets = 0;
+}
 
-                        mPacketHandler.Update(mEthernetData);
+XLinkKaiConnection::Command XLinkKaiConnection::ClassifyCommand(std::string_view aData)
+{
+    Command lReturn{Command::Unknown};
+
+    // The first character already tells the commands we care about apart
+    switch (aData.front()) {
+        case cEthernetDataFormat.front():
+            // This is the path every packet takes, so just check e;?; byte by byte
+            if ((aData.size() >= cEthernetDataString.size()) && (aData[1] == cSeparator.front()) &&
+                (aData[3] == cSeparator.front())) {
+                if (aData[2] == cEthernetDataFormat.front()) {
+                    lReturn = Command::EthernetData;
+                } else if (aData[2] == cEthernetDataMetaFormat.front()) {
+                    lReturn = Command::EthernetDataMeta;
+                }
+            }
+            break;
+        case cKeepAliveFormat.front():
+            if (aData.starts_with(cKeepAliveString)) {
+                lReturn = Command::KeepAlive;
+            }
+            break;
+        case cConnectedFormat.front():
+            if (aData.starts_with(cConnectedString)) {
+                lReturn = Command::Connected;
+            }
+            break;
+        case cDisconnectedFormat.front():
+            if (aData.starts_with(cDisconnectedString)) {
+                lReturn = Command::Disconnected;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return lReturn;
+}
 
-                        std::shared_ptr<MonitorDevice> lMonitorDevice =
-                            std::dynamic_pointer_cast<MonitorDevice>(mIncomingConnection);
+void XLinkKaiConnection::HandleReceivedData(std::string_view                      aData,
+                                            std::chrono::system_clock::time_point aArrival)
+{
+    // If we actually received anything useful, react.
+    if (!aData.empty()) {
+        // Make sure the keepalive timer gets tickled so it doesn't bite.
+        mKeepAliveTimerStart += (std::chrono::system_clock::now() - mKeepAliveTimerStart);
+        const Command lCommand{ClassifyCommand(aData)};
+
+        if ((lCommand != Command::EthernetData) && Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+            Logger::GetInstance().Log("Received: " + std::string(aData), Logger::Level::TRACE);
+        }
+
+        if (!mConnected && (lCommand == Command::Connected)) {
+            Logger::GetInstance().Log("XLink Kai succesfully connected: " + cConnectedString, Logger::Level::INFO);
+            mConnectInitiated = false;
+            mConnected        = true;
+        } else if (mConnected) {
+            // If no connection confirmation has been sent on XLink Kai's side, Don't care about any other message yet
+            switch (lCommand) {
+                case Command::KeepAlive:
+                    HandleKeepAlive();
+                    break;
+                case Command::EthernetData:
+                    // Strip e;e;
+                    mEthernetData = aData.substr(cEthernetDataString.length());
+
+                    if (Logger::GetInstance().ShouldLog(Logger::Level::TRACE)) {
+                        Logger::GetInstance().Log("Received: " + PrettyHexString(mEthernetData), Logger::Level::TRACE);
+                    }
+
+                    if (mIncomingConnection != nullptr) {
+                        mPacketHandler.Update(mEthernetData);
 
                         // If it is actually a monitor device, do convert.
-                        if (lMonitorDevice != nullptr) {
-                            mEthernetData = mPacketHandler.ConvertPacketOut(lMonitorDevice->GetLockedBSSID(),
-                                                                            lMonitorDevice->GetDataPacketParameters());
+                        if (mIncomingMonitorDevice != nullptr) {
+                            mEthernetData =
+                                mPacketHandler.ConvertPacketOut(mIncomingMonitorDevice->GetLockedBSSID(),
+                                                                mIncomingMonitorDevice->GetDataPacketParameters());
                         }
 
+                        LatencyStatistics::GetInstance().Record(
+                            LatencyStatistics_Constants::ToDevice, LatencyStatistics_Constants::Converted, aArrival);
+
                         // Data from XLink Kai should never be caught in the receiver thread
                         mIncomingConnection->BlackList(mPacketHandler.GetSourceMac());
-                        mIncomingConnection->Send(mEthernetData);
+                        // Queued, the receive callback flushes once it handled everything that came in at once
+                        if (mIncomingConnection->Queue(mEthernetData)) {
+                            mQueuedPackets++;
+                        }
                     }
-                } else if (lCommand == cEthernetDataMetaString) {
-                    if (lData.substr(cEthernetDataMetaString.length(), cSetESSIDFormat.length()) == cSetESSIDFormat) {
-                        Logger::GetInstance().Log(
-                            "XLink Kai gave us the following ESSID: " + lData.substr(cSetESSIDString.length()),
-                            Logger::Level::DEBUG);
+                    break;
+                case Command::EthernetDataMeta:
+                    if (aData.substr(cEthernetDataMetaString.length()).starts_with(cSetESSIDFormat)) {
+                        Logger::GetInstance().Log("XLink Kai gave us the following ESSID: " +
+                                                      std::string(aData.substr(cSetESSIDString.length())),
+                                                  Logger::Level::DEBUG);
 
                         if (!mHosting && mUseHostSSID) {
-                            mIncomingConnection->Connect(lData.substr(cSetESSIDString.length()));
+                            mIncomingConnection->Connect(aData.substr(cSetESSIDString.length()));
                         }
                     } else {
-                        Logger::GetInstance().Log(std::string("Unrecognized e;d message from XLink Kai: ") + lData,
+                        Logger::GetInstance().Log("Unrecognized e;d message from XLink Kai: " + std::string(aData),
                                                   Logger::Level::DEBUG);
                     }
-                }
-            } else if (lCommand == std::string(cDisconnectedFormat) + cSeparator.data()) {
-                lCommand = lData.substr(0, cDisconnectedString.size());
-                if (lCommand == cDisconnectedString) {
-                    Logger::GetInstance().Log("Xlink Kai has disconnected us! " + lCommand, Logger::Level::ERROR);
+                    break;
+                case Command::Disconnected:
+                    Logger::GetInstance().Log("Xlink Kai has disconnected us! " + cDisconnectedString,
+                                              Logger::Level::ERROR);
                     mConnected = false;
-                }
+                    break;
+                default:
+                    break;
             }
         }
     }
-
-    StartReceiverThread();
 }
 
 bool XLinkKaiConnection::StartReceiverThread()
 {
     bool lReturn{true};
     if (mSocket.is_open()) {
+#ifdef __linux__
+        // Wait for the socket to become readable, then pull everything that is queued in as few syscalls as possible
+        mSocket.async_wait(socket_base::wait_read,
+                           boost::bind(&XLinkKaiConnection::ReceiveBatchCallback, this, placeholders::error));
+#else
         mSocket.async_receive_from(
             buffer(mData, cMaxLength),
             mRemote,
             boost::bind(
                 &XLinkKaiConnection::ReceiveCallback, this, placeholders::error, placeholders::bytes_transferred));
+#endif
         // Run
         if (mReceiverThread == nullptr) {
+            StartSenderThread();
             mReceiverThread = std::make_shared<std::thread>([&] {
                 mIoService.restart();
                 while (!mIoService.stopped()) {
-                    if ((!mConnected && !mConnectInitiated)) {
-                        // Lost connection somewhere, reconnect.
-                        Close(false);
-                        Open(mIp, mPort);
-                        Connect();
-                        std::this_thread::sleep_for(std::chrono::seconds(1));
-                    } else if ((!mConnected) && mConnectInitiated &&
-                               (std::chrono::system_clock::now() > (mConnectionTimerStart + cConnectionTimeout))) {
-                        Logger::GetInstance().Log("Timeout waiting for XLink Kai to connect", Logger::Level::ERROR);
-                        mConnectInitiated = false;
-                        mConnected        = false;
-                        mSettingsSent     = false;
-                        // Retry in 10 seconds
-                        std::this_thread::sleep_for(10s);
-                    } else if (mConnected && !mConnectInitiated &&
-                               (std::chrono::system_clock::now() > (mKeepAliveTimerStart + cKeepAliveTimeout))) {
-                        // KaiEngine stopped sending keepalive messages, must've died.
-                        Logger::GetInstance().Log("It seems KaiEngine has stopped responding, resetting connection ...",
-                                                  Logger::Level::ERROR);
-                        mConnected        = false;
-                        mConnectInitiated = false;
-                        mSettingsSent     = false;
-                    } else if (mConnected && !mConnectInitiated && !mSettingsSent) {
-                        Send(cSettingDDSOnlyString, "");
-                        mSettingsSent = true;
+                    std::chrono::milliseconds lWait{CheckConnection()};
+                    if (lWait.count() > 0) {
+                        std::this_thread::sleep_for(lWait);
                     } else {
                         mIoService.poll();
                         // Very small delay to make the computer happy
@@ -273,6 +428,78 @@ bool XLinkKaiConnection::StartReceiverThread()
 }
 
 
+std::chrono::milliseconds XLinkKaiConnection::CheckConnection()
+{
+    std::chrono::milliseconds lWait{0};
+
+    if ((!mConnected && !mConnectInitiated)) {
+        // Lost connection somewhere, reconnect.
+        Close(false);
+        Open(mIp, mPort);
+        Connect();
+        lWait = 1s;
+    } else if ((!mConnected) && mConnectInitiated &&
+               (std::chrono::system_clock::now() > (mConnectionTimerStart + cConnectionTimeout))) {
+        Logger::GetInstance().Log("Timeout waiting for XLink Kai to connect", Logger::Level::ERROR);
+        mConnectInitiated = false;
+        mConnected        = false;
+        mSettingsSent     = false;
+        // Retry in 10 seconds
+        lWait = 10s;
+    } else if (mConnected && !mConnectInitiated &&
+               (std::chrono::system_clock::now() > (mKeepAliveTimerStart + cKeepAliveTimeout))) {
+        // KaiEngine stopped sending keepalive messages, must've died.
+        Logger::GetInstance().Log("It seems KaiEngine has stopped responding, resetting connection ...",
+                                  Logger::Level::ERROR);
+        mConnected        = false;
+        mConnectInitiated = false;
+        mSettingsSent     = false;
+    } else if (mConnected && !mConnectInitiated && !mSettingsSent) {
+        Send(cSettingDDSOnlyString, "");
+        mSettingsSent = true;
+    }
+
+    return lWait;
+}
+
+bool XLinkKaiConnection::AddToReactor(std::shared_ptr<Reactor> aReactor)
+{
+    bool lReturn{false};
+
+#ifdef __linux__
+    if (mReceiverThread == nullptr) {
+        mReactor = std::move(aReactor);
+
+        lReturn = !mSocket.is_open() || AddSocketToReactor();
+
+        // Takes over from the receiver thread loop, checking more often than needed costs next to nothing
+        mReactor->AddTimer(cReactorInterval, [&] {
+            auto lNow{std::chrono::steady_clock::now()};
+            if (lNow >= mNextConnectionCheck) {
+                mNextConnectionCheck = lNow + CheckConnection();
+            }
+        });
+    } else {
+        Logger::GetInstance().Log("Receiver thread already running, can't add to reactor", Logger::Level::ERROR);
+    }
+#else
+    Logger::GetInstance().Log("The reactor is not supported on this platform", Logger::Level::ERROR);
+#endif
+
+    return lReturn;
+}
+
+bool XLinkKaiConnection::AddSocketToReactor()
+{
+    bool lReturn{false};
+
+#ifdef __linux__
+    lReturn = mReactor->AddReadable(mSocket.native_handle(), [&] { ReceiveBatch(); });
+#endif
+
+    return lReturn;
+}
+
 void XLinkKaiConnection::Close()
 {
     Close(true);
@@ -287,6 +514,20 @@ void XLinkKaiConnection::Close(bool aKillThread)
             mConnectInitiated = false;
         }
 
+        if (aKillThread && mSenderThread != nullptr) {
+            mUseSendRing.store(false, std::memory_order_release);
+            mSenderRunning = false;
+            mSendRing.Signal();
+            mSenderThread->join();
+            mSenderThread = nullptr;
+
+            if (mSendRing.GetDroppedCount() > 0) {
+                Logger::GetInstance().Log("Packets dropped because XLink Kai could not keep up: " +
+                                              std::to_string(mSendRing.GetDroppedCount()),
+                                          Logger::Level::WARNING);
+            }
+        }
+
         if (aKillThread && mReceiverThread != nullptr) {
             if (!mIoService.stopped()) {
                 mIoService.stop();
@@ -296,8 +537,15 @@ void XLinkKaiConnection::Close(bool aKillThread)
         }
 
         if (mSocket.is_open()) {
+            if (mReactor != nullptr) {
+                mReactor->RemoveReadable(mSocket.native_handle());
+            }
             mSocket.close();
         }
+
+        if (aKillThread) {
+            mReactor = nullptr;
+        }
     } catch (...) {
         std::cout << "Failed to disconnect :( " + boost::current_exception_diagnostic_information() << std::endl;
     }
@@ -320,5 +568,6 @@ void XLinkKaiConnection::SetPort(unsigned int aPort)
 
 void XLinkKaiConnection::SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice)
 {
-    mIncomingConnection = aDevice;
+    mIncomingConnection    = aDevice;
+    mIncomingMonitorDevice = std::dynamic_pointer_cast<MonitorDevice>(aDevice);
 }
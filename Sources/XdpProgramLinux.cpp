@@ -0,0 +1,289 @@
+/* Copyright (c) 2021 [Rick de Bondt] - XdpProgramLinux.cpp */
+
+#include "XdpProgramLinux.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace XdpProgram_Constants;
+
+namespace
+{
+    constexpr int16_t cSourceAddressIndex{6};
+    constexpr int16_t cEtherTypeIndex{12};
+    constexpr int32_t cEthernetHeaderLength{14};
+
+    long Bpf(bpf_cmd aCommand, bpf_attr& aAttributes)
+    {
+        return syscall(__NR_bpf, aCommand, &aAttributes, sizeof(aAttributes));
+    }
+
+    bpf_insn Instruction(uint8_t aCode, uint8_t aDestination, uint8_t aSource, int16_t aOffset, int32_t aImmediate)
+    {
+        bpf_insn lInstruction{};
+        lInstruction.code    = aCode;
+        lInstruction.dst_reg = aDestination & 0xFU;
+        lInstruction.src_reg = aSource & 0xFU;
+        lInstruction.off     = aOffset;
+        lInstruction.imm     = aImmediate;
+        return lInstruction;
+    }
+
+    /**
+     * Builds an XDP program that redirects Ethernet frames with one of the given ethertypes to the socket in the map
+     * for the queue the frame came in on, unless their source is in the pass map. Everything else is passed on to the
+     * kernel stack.
+     */
+    std::vector<bpf_insn> BuildProgram(const std::vector<uint16_t>& aEtherTypes, int aSocketMap, int aPassMap)
+    {
+        std::vector<bpf_insn> lProgram{};
+        // Jumps that still need their offset, filled in once it is known where they go
+        std::vector<size_t> lPassJumps{};
+        std::vector<size_t> lMatchJumps{};
+
+        // r6 = context, helper calls don't keep r1 to r5
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0));
+
+        // r2 = data, r3 = data_end, frames too short for an Ethernet header are passed
+        lProgram.push_back(Instruction(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, data), 0));
+        lProgram.push_back(Instruction(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_3, BPF_REG_6, offsetof(xdp_md, data_end), 0));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, cEthernetHeaderLength));
+        lPassJumps.push_back(lProgram.size());
+        lProgram.push_back(Instruction(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 0, 0));
+
+        // r4 = ethertype, frames with none of ours are passed
+        lProgram.push_back(Instruction(BPF_LDX | BPF_H | BPF_MEM, BPF_REG_4, BPF_REG_2, cEtherTypeIndex, 0));
+        for (uint16_t lEtherType : aEtherTypes) {
+            lMatchJumps.push_back(lProgram.size());
+            lProgram.push_back(Instruction(BPF_JMP | BPF_JEQ | BPF_K, BPF_REG_4, 0, 0, lEtherType));
+        }
+        lPassJumps.push_back(lProgram.size());
+        lProgram.push_back(Instruction(BPF_JMP | BPF_JA, 0, 0, 0, 0));
+
+        // r4 = source Mac in the same byte order as NetConversionFunctions uses, frames from a source in the pass map
+        // are passed, so the adapter and everything the device filters out keep reaching the kernel stack
+        const size_t lMatch{lProgram.size()};
+        lProgram.push_back(Instruction(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_4, BPF_REG_2, cSourceAddressIndex, 0));
+        lProgram.push_back(Instruction(BPF_LDX | BPF_H | BPF_MEM, BPF_REG_5, BPF_REG_2, cSourceAddressIndex + 4, 0));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_LSH | BPF_K, BPF_REG_5, 0, 0, 32));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_OR | BPF_X, BPF_REG_4, BPF_REG_5, 0, 0));
+        lProgram.push_back(Instruction(BPF_STX | BPF_DW | BPF_MEM, BPF_REG_10, BPF_REG_4, -8, 0));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_10, 0, 0));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_2, 0, 0, -8));
+        lProgram.push_back(Instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, aPassMap));
+        lProgram.push_back(Instruction(0, 0, 0, 0, 0));
+        lProgram.push_back(Instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem));
+        lPassJumps.push_back(lProgram.size());
+        lProgram.push_back(Instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 0, 0));
+
+        // Redirect, if there is no socket for the queue the frame goes to the kernel stack instead
+        lProgram.push_back(
+            Instruction(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, rx_queue_index), 0));
+        lProgram.push_back(Instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, aSocketMap));
+        lProgram.push_back(Instruction(0, 0, 0, 0, 0));
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS));
+        lProgram.push_back(Instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map));
+        lProgram.push_back(Instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+        // Pass
+        const size_t lPass{lProgram.size()};
+        lProgram.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS));
+        lProgram.push_back(Instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+        // Offsets count from the instruction after the jump
+        for (size_t lJump : lPassJumps) {
+            lProgram.at(lJump).off = static_cast<int16_t>(lPass - lJump - 1);
+        }
+        for (size_t lJump : lMatchJumps) {
+            lProgram.at(lJump).off = static_cast<int16_t>(lMatch - lJump - 1);
+        }
+
+        return lProgram;
+    }
+
+    /**
+     * Adds Mac addresses to the pass map.
+     * @return true if successful, check errno when not.
+     */
+    bool AddToPassMap(int aPassMap, const std::vector<uint64_t>& aSources)
+    {
+        bool lReturn{true};
+
+        for (uint64_t lSource : aSources) {
+            uint8_t lValue{1};
+
+            bpf_attr lUpdateAttributes{};
+            lUpdateAttributes.map_fd = static_cast<uint32_t>(aPassMap);
+            lUpdateAttributes.key    = reinterpret_cast<uint64_t>(&lSource);
+            lUpdateAttributes.value  = reinterpret_cast<uint64_t>(&lValue);
+
+            if (Bpf(BPF_MAP_UPDATE_ELEM, lUpdateAttributes) != 0) {
+                lReturn = false;
+            }
+        }
+
+        return lReturn;
+    }
+}  // namespace
+
+XdpProgram::~XdpProgram()
+{
+    Detach();
+}
+
+bool XdpProgram::Attach(unsigned int                 aInterfaceIndex,
+                        unsigned int                 aQueueId,
+                        int                          aSocket,
+                        const std::vector<uint16_t>& aEtherTypes)
+{
+    bool lReturn{true};
+
+    mQueueId = aQueueId;
+
+    bpf_attr lMapAttributes{};
+    lMapAttributes.map_type    = BPF_MAP_TYPE_XSKMAP;
+    lMapAttributes.key_size    = sizeof(uint32_t);
+    lMapAttributes.value_size  = sizeof(uint32_t);
+    lMapAttributes.max_entries = cMaxQueues;
+
+    mMap = static_cast<int>(Bpf(BPF_MAP_CREATE, lMapAttributes));
+    if (mMap < 0) {
+        mError  = std::string("Could not create XSKMAP: ") + strerror(errno);
+        lReturn = false;
+    }
+
+    if (lReturn) {
+        uint32_t lKey{mQueueId};
+        auto     lValue{static_cast<uint32_t>(aSocket)};
+
+        bpf_attr lUpdateAttributes{};
+        lUpdateAttributes.map_fd = static_cast<uint32_t>(mMap);
+        lUpdateAttributes.key    = reinterpret_cast<uint64_t>(&lKey);
+        lUpdateAttributes.value  = reinterpret_cast<uint64_t>(&lValue);
+
+        if (Bpf(BPF_MAP_UPDATE_ELEM, lUpdateAttributes) != 0) {
+            mError  = std::string("Could not add socket to XSKMAP: ") + strerror(errno);
+            lReturn = false;
+        }
+    }
+
+    if (lReturn) {
+        bpf_attr lPassMapAttributes{};
+        lPassMapAttributes.map_type    = BPF_MAP_TYPE_HASH;
+        lPassMapAttributes.key_size    = sizeof(uint64_t);
+        lPassMapAttributes.value_size  = sizeof(uint8_t);
+        lPassMapAttributes.max_entries = cMaxPassedSources;
+
+        mPassMap = static_cast<int>(Bpf(BPF_MAP_CREATE, lPassMapAttributes));
+        if (mPassMap < 0) {
+            mError  = std::string("Could not create pass map: ") + strerror(errno);
+            lReturn = false;
+        } else if (!AddToPassMap(mPassMap, mPassedSources)) {
+            mError  = std::string("Could not add sources to pass map: ") + strerror(errno);
+            lReturn = false;
+        }
+    }
+
+    if (lReturn) {
+        std::vector<bpf_insn> lProgram{BuildProgram(aEtherTypes, mMap, mPassMap)};
+        constexpr char        cLicense[]{"Dual MIT/GPL"};
+
+        bpf_attr lProgramAttributes{};
+        lProgramAttributes.prog_type = BPF_PROG_TYPE_XDP;
+        lProgramAttributes.insns     = reinterpret_cast<uint64_t>(lProgram.data());
+        lProgramAttributes.insn_cnt  = static_cast<uint32_t>(lProgram.size());
+        lProgramAttributes.license   = reinterpret_cast<uint64_t>(cLicense);
+
+        mProgram = static_cast<int>(Bpf(BPF_PROG_LOAD, lProgramAttributes));
+        if (mProgram < 0) {
+            mError  = std::string("Could not load XDP program: ") + strerror(errno);
+            lReturn = false;
+        }
+    }
+
+    if (lReturn) {
+        // A link instead of a netlink attach, so nothing stays attached when we crash
+        bpf_attr lLinkAttributes{};
+        lLinkAttributes.link_create.prog_fd        = static_cast<uint32_t>(mProgram);
+        lLinkAttributes.link_create.target_ifindex = aInterfaceIndex;
+        lLinkAttributes.link_create.attach_type    = BPF_XDP;
+        lLinkAttributes.link_create.flags          = XDP_FLAGS_SKB_MODE;
+
+        mLink = static_cast<int>(Bpf(BPF_LINK_CREATE, lLinkAttributes));
+        if (mLink < 0) {
+            mError  = std::string("Could not attach XDP program: ") + strerror(errno);
+            lReturn = false;
+        }
+    }
+
+    if (!lReturn) {
+        // Keep errno for the caller
+        const int lError{errno};
+        Detach();
+        errno = lError;
+    }
+
+    return lReturn;
+}
+
+void XdpProgram::Detach()
+{
+    // The map holds on to the socket until it is freed somewhere later, which keeps the queue busy for a new socket
+    if (mMap >= 0) {
+        uint32_t lKey{mQueueId};
+
+        bpf_attr lDeleteAttributes{};
+        lDeleteAttributes.map_fd = static_cast<uint32_t>(mMap);
+        lDeleteAttributes.key    = reinterpret_cast<uint64_t>(&lKey);
+        Bpf(BPF_MAP_DELETE_ELEM, lDeleteAttributes);
+    }
+
+    for (int* lFileDescriptor : {&mLink, &mProgram, &mPassMap, &mMap}) {
+        if (*lFileDescriptor >= 0) {
+            close(*lFileDescriptor);
+            *lFileDescriptor = -1;
+        }
+    }
+}
+
+bool XdpProgram::PassSources(const std::vector<uint64_t>& aSources)
+{
+    bool lReturn{true};
+
+    std::vector<uint64_t> lNewSources{};
+    for (uint64_t lSource : aSources) {
+        if (std::find(mPassedSources.begin(), mPassedSources.end(), lSource) == mPassedSources.end()) {
+            lNewSources.push_back(lSource);
+        }
+    }
+
+    if (mPassedSources.size() + lNewSources.size() > cMaxPassedSources) {
+        mError  = "Too many sources to pass to the kernel stack";
+        lReturn = false;
+    } else if (mPassMap >= 0 && !AddToPassMap(mPassMap, lNewSources)) {
+        mError  = std::string("Could not add sources to pass map: ") + strerror(errno);
+        lReturn = false;
+    } else {
+        mPassedSources.insert(mPassedSources.end(), lNewSources.begin(), lNewSources.end());
+    }
+
+    return lReturn;
+}
+
+const std::string& XdpProgram::GetError() const
+{
+    return mError;
+}
+
+bool XdpProgram::IsAttached() const
+{
+    return mLink >= 0;
+}
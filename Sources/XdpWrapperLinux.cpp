@@ -0,0 +1,626 @@
+/* Copyright (c) 2021 [Rick de Bondt] - XdpWrapperLinux.cpp */
+
+#include "XdpWrapperLinux.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <net/if.h>
+#include <linux/if_xdp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "Logger.h"
+
+using namespace XdpWrapper_Constants;
+
+namespace
+{
+    // Sent frames start at the beginning of a frame, there is no headroom to keep free like when receiving
+    constexpr unsigned int cMaxFrameLength{cFrameSize};
+    constexpr uint64_t     cFrameMask{~static_cast<uint64_t>(cFrameSize - 1)};
+
+    uint32_t Load(uint32_t* aIndex)
+    {
+        return std::atomic_ref<uint32_t>(*aIndex).load(std::memory_order_acquire);
+    }
+
+    void Store(uint32_t* aIndex, uint32_t aValue)
+    {
+        std::atomic_ref<uint32_t>(*aIndex).store(aValue, std::memory_order_release);
+    }
+}  // namespace
+
+XdpWrapper::XdpWrapper(std::vector<uint16_t> aEtherTypes) : mEtherTypes(std::move(aEtherTypes)) {}
+
+XdpWrapper::~XdpWrapper()
+{
+    Close();
+}
+
+int XdpWrapper::Activate()
+{
+    int lReturn{0};
+
+    const unsigned int lIndex{if_nametoindex(mInterface.c_str())};
+
+    if (IsActivated()) {
+        lReturn = PCAP_ERROR_ACTIVATED;
+    } else if (lIndex == 0) {
+        SetError("No such device: " + mInterface);
+        lReturn = PCAP_ERROR_NO_SUCH_DEVICE;
+    } else {
+        mSocket     = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+        mBreakEvent = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (mSocket < 0) {
+            SetError(std::string("Could not create AF_XDP socket: ") + strerror(errno));
+            lReturn = (errno == EPERM || errno == EACCES) ? PCAP_ERROR_PERM_DENIED : PCAP_ERROR;
+        }
+    }
+
+    if (lReturn == 0) {
+        if (SetUpRings()) {
+            sockaddr_xdp lAddress{};
+            lAddress.sxdp_family   = AF_XDP;
+            lAddress.sxdp_flags    = XDP_COPY;
+            lAddress.sxdp_ifindex  = lIndex;
+            lAddress.sxdp_queue_id = cQueueId;
+
+            // The kernel releases a queue in the background after the socket on it is closed, so after a reconnect
+            // it can still be busy for a moment
+            int lBound{bind(mSocket, reinterpret_cast<sockaddr*>(&lAddress), sizeof(lAddress))};
+            for (unsigned int lTries = 0; lBound != 0 && errno == EBUSY && lTries < cBindRetries; lTries++) {
+                std::this_thread::sleep_for(cBindRetryInterval);
+                lBound = bind(mSocket, reinterpret_cast<sockaddr*>(&lAddress), sizeof(lAddress));
+            }
+
+            if (lBound != 0) {
+                SetError(std::string("Could not bind AF_XDP socket to ") + mInterface + ": " + strerror(errno));
+                lReturn = PCAP_ERROR;
+            } else if (!mProgram.Attach(lIndex, cQueueId, mSocket, mEtherTypes)) {
+                SetError(mProgram.GetError());
+                lReturn = (errno == EPERM || errno == EACCES) ? PCAP_ERROR_PERM_DENIED : PCAP_ERROR;
+            }
+        } else {
+            lReturn = PCAP_ERROR;
+        }
+    }
+
+    if (lReturn != 0 && lReturn != PCAP_ERROR_ACTIVATED) {
+        Logger::GetInstance().Log(mError.data(), Logger::Level::ERROR);
+        Close();
+    }
+
+    return lReturn;
+}
+
+bool XdpWrapper::SetUpRings()
+{
+    bool lReturn{true};
+
+    void* lUmem{mmap(nullptr,
+                     static_cast<size_t>(cFrameSize) * cFrameCount,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1,
+                     0)};
+
+    if (lUmem == MAP_FAILED) {
+        SetError(std::string("Could not allocate UMEM: ") + strerror(errno));
+        lReturn = false;
+    } else {
+        mUmem = static_cast<uint8_t*>(lUmem);
+
+        xdp_umem_reg lRegistration{};
+        lRegistration.addr       = reinterpret_cast<uint64_t>(mUmem);
+        lRegistration.len        = static_cast<uint64_t>(cFrameSize) * cFrameCount;
+        lRegistration.chunk_size = cFrameSize;
+
+        int lRingSize{cRingSize};
+        if (setsockopt(mSocket, SOL_XDP, XDP_UMEM_REG, &lRegistration, sizeof(lRegistration)) != 0 ||
+            setsockopt(mSocket, SOL_XDP, XDP_UMEM_FILL_RING, &lRingSize, sizeof(lRingSize)) != 0 ||
+            setsockopt(mSocket, SOL_XDP, XDP_UMEM_COMPLETION_RING, &lRingSize, sizeof(lRingSize)) != 0 ||
+            setsockopt(mSocket, SOL_XDP, XDP_RX_RING, &lRingSize, sizeof(lRingSize)) != 0 ||
+            setsockopt(mSocket, SOL_XDP, XDP_TX_RING, &lRingSize, sizeof(lRingSize)) != 0) {
+            SetError(std::string("Could not set up AF_XDP rings: ") + strerror(errno));
+            lReturn = false;
+        }
+    }
+
+    xdp_mmap_offsets lOffsets{};
+    socklen_t        lOffsetsLength{sizeof(lOffsets)};
+    if (lReturn && getsockopt(mSocket, SOL_XDP, XDP_MMAP_OFFSETS, &lOffsets, &lOffsetsLength) != 0) {
+        SetError(std::string("Could not get AF_XDP ring offsets: ") + strerror(errno));
+        lReturn = false;
+    }
+
+    auto lMapRing = [&](Ring& aRing, const xdp_ring_offset& aOffset, size_t aDescriptorSize, off_t aPageOffset) {
+        aRing.MapSize = aOffset.desc + cRingSize * aDescriptorSize;
+        aRing.Map     = mmap(nullptr, aRing.MapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mSocket,
+                         aPageOffset);
+
+        if (aRing.Map == MAP_FAILED) {
+            aRing.Map = nullptr;
+            SetError(std::string("Could not map AF_XDP ring: ") + strerror(errno));
+            lReturn = false;
+        } else {
+            auto* lBase{static_cast<uint8_t*>(aRing.Map)};
+            aRing.Producer    = reinterpret_cast<uint32_t*>(lBase + aOffset.producer);
+            aRing.Consumer    = reinterpret_cast<uint32_t*>(lBase + aOffset.consumer);
+            aRing.Descriptors = lBase + aOffset.desc;
+        }
+    };
+
+    if (lReturn) {
+        lMapRing(mFillRing, lOffsets.fr, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING);
+    }
+    if (lReturn) {
+        lMapRing(mCompletionRing, lOffsets.cr, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING);
+    }
+    if (lReturn) {
+        lMapRing(mReceiveRing, lOffsets.rx, sizeof(xdp_desc), XDP_PGOFF_RX_RING);
+    }
+    if (lReturn) {
+        lMapRing(mTransmitRing, lOffsets.tx, sizeof(xdp_desc), XDP_PGOFF_TX_RING);
+    }
+
+    if (lReturn) {
+        // The first half of the frames is handed to the kernel for receiving, the rest is ours for sending
+        auto* lFill{reinterpret_cast<uint64_t*>(mFillRing.Descriptors)};
+        for (unsigned int lCount = 0; lCount < cRingSize; lCount++) {
+            lFill[lCount] = static_cast<uint64_t>(lCount) * cFrameSize;
+        }
+        mFillRing.Cached = cRingSize;
+        Store(mFillRing.Producer, mFillRing.Cached);
+
+        mFreeFrames.clear();
+        for (unsigned int lCount = cRingSize; lCount < cFrameCount; lCount++) {
+            mFreeFrames.push_back(static_cast<uint64_t>(lCount) * cFrameSize);
+        }
+    }
+
+    return lReturn;
+}
+
+void XdpWrapper::BreakLoop()
+{
+    mBreakLoop = true;
+
+    if (mBreakEvent >= 0) {
+        eventfd_write(mBreakEvent, 1);
+    }
+}
+
+void XdpWrapper::Close()
+{
+    // Detach the program first, so the kernel stack gets everything again
+    mProgram.Detach();
+
+    for (int* lFileDescriptor : {&mSocket, &mBreakEvent}) {
+        if (*lFileDescriptor >= 0) {
+            close(*lFileDescriptor);
+            *lFileDescriptor = -1;
+        }
+    }
+
+    for (Ring* lRing : {&mFillRing, &mCompletionRing, &mReceiveRing, &mTransmitRing}) {
+        if (lRing->Map != nullptr) {
+            munmap(lRing->Map, lRing->MapSize);
+        }
+        *lRing = {};
+    }
+
+    if (mUmem != nullptr) {
+        munmap(mUmem, static_cast<size_t>(cFrameSize) * cFrameCount);
+        mUmem = nullptr;
+    }
+
+    mPending  = 0;
+    mReceived = 0;
+    mFreeFrames.clear();
+}
+
+pcap_t* XdpWrapper::Create(const char* source, char* /*errbuf*/)
+{
+    mInterface = source;
+    return nullptr;
+}
+
+int XdpWrapper::Dispatch(int cnt, pcap_handler callback, unsigned char* user)
+{
+    int lReturn{0};
+
+    if (IsActivated()) {
+        ReleaseFrames();
+
+        // Like pcap, wait for the first packets unless in non-blocking mode
+        if (!mNonBlock && Load(mReceiveRing.Producer) == mReceiveRing.Cached) {
+            WaitForFrames();
+        }
+
+        // AF_XDP has no timestamps, everything in this batch arrived at about the same time anyway
+        gettimeofday(&mHeader.ts, nullptr);
+
+        uint32_t lAvailable{Load(mReceiveRing.Producer) - mReceiveRing.Cached};
+        if (cnt > 0) {
+            lAvailable = std::min(lAvailable, static_cast<uint32_t>(cnt));
+        }
+
+        auto* lDescriptors{reinterpret_cast<xdp_desc*>(mReceiveRing.Descriptors)};
+        while (!mBreakLoop && mPending < lAvailable) {
+            const xdp_desc& lDescriptor{lDescriptors[(mReceiveRing.Cached + mPending) & (cRingSize - 1)]};
+            mHeader.caplen = std::min(lDescriptor.len, static_cast<uint32_t>(mSnapLen));
+            mHeader.len    = lDescriptor.len;
+            mPending++;
+
+            callback(user, &mHeader, mUmem + lDescriptor.addr);
+            lReturn++;
+        }
+
+        ReleaseFrames();
+
+        if (mBreakLoop.exchange(false)) {
+            lReturn = PCAP_ERROR_BREAK;
+        }
+    } else {
+        SetError("Dispatch called on a device that has not been activated");
+        lReturn = PCAP_ERROR;
+    }
+
+    return lReturn;
+}
+
+void XdpWrapper::Dump(unsigned char* user, pcap_pkthdr* header, unsigned char* message)
+{
+    pcap_dump(user, header, message);
+}
+
+void XdpWrapper::DumpClose(pcap_dumper_t* dumper)
+{
+    pcap_dump_close(dumper);
+}
+
+pcap_dumper_t* XdpWrapper::DumpOpen(const char* /*outputfile*/)
+{
+    SetError("Dumping is not supported on an AF_XDP capture");
+    return nullptr;
+}
+
+int XdpWrapper::FindAllDevices(pcap_if_t** alldevicesp, char* errbuf)
+{
+    return pcap_findalldevs(alldevicesp, errbuf);
+}
+
+void XdpWrapper::FreeAllDevices(pcap_if_t* devices)
+{
+    pcap_freealldevs(devices);
+}
+
+int XdpWrapper::GetDatalink()
+{
+    return DLT_EN10MB;
+}
+
+char* XdpWrapper::GetError()
+{
+    return mError.data();
+}
+
+int XdpWrapper::GetSelectableFd()
+{
+    // The socket becomes readable as soon as something is on the receive ring
+    return mSocket;
+}
+
+int XdpWrapper::GetStatistics(pcap_stat* stats)
+{
+    int            lReturn{PCAP_ERROR};
+    xdp_statistics lStatistics{};
+    socklen_t      lLength{sizeof(lStatistics)};
+
+    if (mSocket < 0) {
+        SetError("GetStatistics called on a device that has not been activated");
+    } else if (getsockopt(mSocket, SOL_XDP, XDP_STATISTICS, &lStatistics, &lLength) != 0) {
+        SetError(std::string("Could not get statistics: ") + strerror(errno));
+    } else {
+        // Like libpcap on Linux, dropped frames are counted as received as well
+        const uint64_t lDropped{lStatistics.rx_dropped + lStatistics.rx_ring_full +
+                                lStatistics.rx_fill_ring_empty_descs};
+        stats->ps_recv   = static_cast<unsigned int>(mReceived + mPending + lDropped);
+        stats->ps_drop   = static_cast<unsigned int>(lDropped);
+        stats->ps_ifdrop = 0;
+        lReturn          = 0;
+    }
+
+    return lReturn;
+}
+
+bool XdpWrapper::IsActivated()
+{
+    return mProgram.IsAttached();
+}
+
+pcap_t* XdpWrapper::OpenDead(int /*linktype*/, int /*snaplen*/)
+{
+    SetError("Savefiles are not supported on an AF_XDP capture");
+    return nullptr;
+}
+
+pcap_t* XdpWrapper::OpenOffline(const char* /*fname*/, char* errbuf)
+{
+    SetError("Savefiles are not supported on an AF_XDP capture");
+    if (errbuf != nullptr) {
+        std::strncpy(errbuf, mError.data(), PCAP_ERRBUF_SIZE - 1);
+    }
+    return nullptr;
+}
+
+int XdpWrapper::NextEx(pcap_pkthdr** header, const unsigned char** pkt_data)
+{
+    int lReturn{0};
+
+    if (IsActivated()) {
+        // The packet handed out last is done with now
+        ReleaseFrames();
+
+        if (!mNonBlock && Load(mReceiveRing.Producer) == mReceiveRing.Cached) {
+            WaitForFrames();
+        }
+
+        if (Load(mReceiveRing.Producer) != mReceiveRing.Cached) {
+            const xdp_desc& lDescriptor{
+                reinterpret_cast<xdp_desc*>(mReceiveRing.Descriptors)[mReceiveRing.Cached & (cRingSize - 1)]};
+            gettimeofday(&mHeader.ts, nullptr);
+            mHeader.caplen = std::min(lDescriptor.len, static_cast<uint32_t>(mSnapLen));
+            mHeader.len    = lDescriptor.len;
+            mPending       = 1;
+
+            *header   = &mHeader;
+            *pkt_data = mUmem + lDescriptor.addr;
+            lReturn   = 1;
+        }
+    } else {
+        SetError("NextEx called on a device that has not been activated");
+        lReturn = PCAP_ERROR;
+    }
+
+    return lReturn;
+}
+
+int XdpWrapper::SendPacket(std::string_view buffer)
+{
+    int lReturn{PCAP_ERROR};
+
+    if (buffer.size() > cMaxFrameLength) {
+        SetError("Packet too large for an AF_XDP frame: " + std::to_string(buffer.size()));
+    } else if (IsActivated()) {
+        ReclaimFrames();
+        if (QueueFrame(buffer) && FlushFrames()) {
+            lReturn = 0;
+        }
+    }
+
+    return lReturn;
+}
+
+int XdpWrapper::SendBatch(std::span<const std::string> buffers)
+{
+    int          lSent{0};
+    bool         lFailed{!IsActivated()};
+    size_t       lIndex{0};
+    unsigned int lWaits{0};
+
+    while (!lFailed && lIndex < buffers.size()) {
+        ReclaimFrames();
+
+        // Put as much as possible on the ring, then kick the kernel once for all of it
+        int lQueued{0};
+        while (lIndex < buffers.size() && buffers[lIndex].size() <= cMaxFrameLength && QueueFrame(buffers[lIndex])) {
+            lIndex++;
+            lQueued++;
+        }
+
+        if (lIndex < buffers.size() && buffers[lIndex].size() > cMaxFrameLength) {
+            SetError("Packet too large for an AF_XDP frame: " + std::to_string(buffers[lIndex].size()));
+            lFailed = true;
+        }
+
+        if (lQueued > 0) {
+            if (FlushFrames()) {
+                lSent += lQueued;
+                lWaits = 0;
+            } else {
+                lFailed = true;
+            }
+        } else if (!lFailed) {
+            // Every frame is still in flight, give the kernel a moment to complete some of them
+            if (++lWaits > cMaxKicks) {
+                SetError("Kernel is not completing packets from the AF_XDP ring");
+                lFailed = true;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    return lFailed ? -1 : lSent;
+}
+
+int XdpWrapper::SetBufferSize(int /*buffer_size*/)
+{
+    SetError("The AF_XDP frame area has a fixed size of " + std::to_string(cFrameSize * cFrameCount / 1024) + " KiB");
+    return PCAP_ERROR;
+}
+
+int XdpWrapper::SetDirection(PcapDirection::Direction direction)
+{
+    // XDP only ever sees incoming frames
+    return direction == PcapDirection::DIR_OUT ? PCAP_ERROR : 0;
+}
+
+int XdpWrapper::SetFilter(std::string_view /*filter*/)
+{
+    SetError("Filters are not supported on an AF_XDP socket, the XDP program already selects the frames");
+    return PCAP_ERROR;
+}
+
+int XdpWrapper::SetImmediateMode(int /*mode*/)
+{
+    // Frames are always available as soon as the XDP program redirected them
+    return IsActivated() ? PCAP_ERROR_ACTIVATED : 0;
+}
+
+int XdpWrapper::SetNonBlock(int nonblock)
+{
+    mNonBlock = (nonblock != 0);
+    return 0;
+}
+
+int XdpWrapper::SetPassedSources(const std::vector<uint64_t>& sources)
+{
+    int lReturn{0};
+
+    if (!mProgram.PassSources(sources)) {
+        SetError(mProgram.GetError());
+        lReturn = PCAP_ERROR;
+    }
+
+    return lReturn;
+}
+
+int XdpWrapper::SetSnapLen(int snaplen)
+{
+    int lReturn{PCAP_ERROR_ACTIVATED};
+
+    if (!IsActivated()) {
+        mSnapLen = snaplen > 0 ? snaplen : UINT16_MAX;
+        lReturn  = 0;
+    }
+
+    return lReturn;
+}
+
+int XdpWrapper::SetTimeOut(int timeout)
+{
+    int lReturn{PCAP_ERROR_ACTIVATED};
+
+    if (!IsActivated()) {
+        mTimeOut = timeout;
+        lReturn  = 0;
+    }
+
+    return lReturn;
+}
+
+void XdpWrapper::ReleaseFrames()
+{
+    if (mPending > 0) {
+        // The fill ring is as big as the amount of receive frames, so there is always room for the ones we give back
+        auto* lDescriptors{reinterpret_cast<xdp_desc*>(mReceiveRing.Descriptors)};
+        auto* lFill{reinterpret_cast<uint64_t*>(mFillRing.Descriptors)};
+
+        for (uint32_t lCount = 0; lCount < mPending; lCount++) {
+            lFill[(mFillRing.Cached + lCount) & (cRingSize - 1)] =
+                lDescriptors[(mReceiveRing.Cached + lCount) & (cRingSize - 1)].addr & cFrameMask;
+        }
+
+        mFillRing.Cached += mPending;
+        mReceiveRing.Cached += mPending;
+        mReceived += mPending;
+        mPending = 0;
+
+        Store(mFillRing.Producer, mFillRing.Cached);
+        Store(mReceiveRing.Consumer, mReceiveRing.Cached);
+    }
+}
+
+void XdpWrapper::WaitForFrames()
+{
+    if (!mBreakLoop) {
+        std::array<pollfd, 2> lFileDescriptors{};
+        lFileDescriptors.at(0).fd     = mSocket;
+        lFileDescriptors.at(0).events = POLLIN;
+        lFileDescriptors.at(1).fd     = mBreakEvent;
+        lFileDescriptors.at(1).events = POLLIN;
+
+        // A timeout of 0 means waiting forever, like pcap
+        poll(lFileDescriptors.data(), lFileDescriptors.size(), mTimeOut > 0 ? mTimeOut : -1);
+
+        eventfd_t lWakeUp{0};
+        eventfd_read(mBreakEvent, &lWakeUp);
+    }
+}
+
+void XdpWrapper::ReclaimFrames()
+{
+    const uint32_t lCompleted{Load(mCompletionRing.Producer) - mCompletionRing.Cached};
+
+    if (lCompleted > 0) {
+        auto* lCompletions{reinterpret_cast<uint64_t*>(mCompletionRing.Descriptors)};
+        for (uint32_t lCount = 0; lCount < lCompleted; lCount++) {
+            mFreeFrames.push_back(lCompletions[(mCompletionRing.Cached + lCount) & (cRingSize - 1)]);
+        }
+
+        mCompletionRing.Cached += lCompleted;
+        Store(mCompletionRing.Consumer, mCompletionRing.Cached);
+    }
+}
+
+bool XdpWrapper::QueueFrame(std::string_view aData)
+{
+    bool lReturn{false};
+
+    if (!mFreeFrames.empty() && (mTransmitRing.Cached - Load(mTransmitRing.Consumer)) < cRingSize) {
+        const uint64_t lFrame{mFreeFrames.back()};
+        mFreeFrames.pop_back();
+
+        std::memcpy(mUmem + lFrame, aData.data(), aData.size());
+
+        xdp_desc& lDescriptor{
+            reinterpret_cast<xdp_desc*>(mTransmitRing.Descriptors)[mTransmitRing.Cached & (cRingSize - 1)]};
+        lDescriptor.addr    = lFrame;
+        lDescriptor.len     = static_cast<uint32_t>(aData.size());
+        lDescriptor.options = 0;
+
+        mTransmitRing.Cached++;
+        Store(mTransmitRing.Producer, mTransmitRing.Cached);
+        lReturn = true;
+    }
+
+    return lReturn;
+}
+
+bool XdpWrapper::FlushFrames()
+{
+    bool         lReturn{true};
+    unsigned int lKicks{0};
+
+    // In copy mode the kernel only sends a few frames per kick, so keep kicking until the ring is empty
+    while (lReturn && Load(mTransmitRing.Consumer) != mTransmitRing.Cached) {
+        if (sendto(mSocket, nullptr, 0, MSG_DONTWAIT, nullptr, 0) < 0 && errno != EAGAIN && errno != EBUSY &&
+            errno != ENOBUFS) {
+            SetError(std::string("Could not send packets: ") + strerror(errno));
+            lReturn = false;
+        } else if (++lKicks > cMaxKicks) {
+            SetError("Kernel is not sending packets from the AF_XDP ring");
+            lReturn = false;
+        }
+    }
+
+    ReclaimFrames();
+
+    return lReturn;
+}
+
+void XdpWrapper::SetError(std::string_view aError)
+{
+    const size_t lLength{aError.copy(mError.data(), mError.size() - 1)};
+    mError.at(lLength) = '\0';
+}
@@ -12,12 +12,18 @@ public:
     MOCK_METHOD(bool, Connect, (std::string_view aESSID));
     MOCK_METHOD(bool, Open, (std::string_view aName, std::vector<std::string>& aSSIDFilter));
     MOCK_METHOD(std::string, DataToString, (const unsigned char* aData, const pcap_pkthdr* aHeader));
+    MOCK_METHOD(std::string_view, DataToStringView, (const unsigned char* aData, const pcap_pkthdr* aHeader));
+    MOCK_METHOD(IPCapDevice_Constants::CaptureStatistics, GetCaptureStatistics, ());
     MOCK_METHOD(const unsigned char*, GetData, ());
     MOCK_METHOD(const pcap_pkthdr*, GetHeader, ());
     MOCK_METHOD(bool, ReadCallback, (const unsigned char* aData, const pcap_pkthdr* aHeader));
     MOCK_METHOD(bool, Send, (std::string_view aData));
+    MOCK_METHOD(bool, Queue, (std::string_view aData));
+    MOCK_METHOD(bool, Flush, ());
+    MOCK_METHOD(void, SetCaptureBufferSize, (unsigned int aBufferSize));
     MOCK_METHOD(void, SetConnector, (std::shared_ptr<IConnector> aDevice));
     MOCK_METHOD(void, SetHosting, (bool aHosting));
     MOCK_METHOD(void, ShowPacketStatistics, (const pcap_pkthdr* aHeader), (const));
     MOCK_METHOD(bool, StartReceiverThread, ());
+    MOCK_METHOD(bool, AddToReactor, (std::shared_ptr<Reactor> aReactor));
 };
\ No newline at end of file
@@ -19,13 +19,20 @@ public:
     MOCK_METHOD(void, FreeAllDevices, (pcap_if_t * devices));
     MOCK_METHOD(int, GetDatalink, ());
     MOCK_METHOD(char*, GetError, ());
+    MOCK_METHOD(int, GetSelectableFd, ());
+    MOCK_METHOD(int, GetStatistics, (pcap_stat * stats));
     MOCK_METHOD(bool, IsActivated, ());
     MOCK_METHOD(pcap_t*, OpenDead, (int linktype, int snaplen));
     MOCK_METHOD(pcap_t*, OpenOffline, (const char* fname, char* errbuf));
     MOCK_METHOD(int, NextEx, (pcap_pkthdr * *header, const unsigned char** pkt_data));
     MOCK_METHOD(int, SendPacket, (std::string_view buffer));
+    MOCK_METHOD(int, SendBatch, (std::span<const std::string> buffers));
+    MOCK_METHOD(int, SetBufferSize, (int buffer_size));
     MOCK_METHOD(int, SetDirection, (PcapDirection::Direction direction));
+    MOCK_METHOD(int, SetFilter, (std::string_view filter));
     MOCK_METHOD(int, SetImmediateMode, (int mode));
+    MOCK_METHOD(int, SetNonBlock, (int nonblock));
+    MOCK_METHOD(int, SetPassedSources, (const std::vector<uint64_t>& sources));
     MOCK_METHOD(int, SetSnapLen, (int snaplen));
     MOCK_METHOD(int, SetTimeOut, (int timeout));
 };
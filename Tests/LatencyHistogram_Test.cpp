@@ -0,0 +1,117 @@
+/* Copyright (c) 2021 [Rick de Bondt] - LatencyHistogram_Test.cpp
+ * This file contains tests for the LatencyHistogram and LatencyStatistics classes.
+ **/
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LatencyHistogram.h"
+#include "LatencyStatistics.h"
+
+using namespace std::chrono_literals;
+
+class LatencyHistogramTest : public ::testing::Test
+{};
+
+// Percentiles should land on the recorded values, off by no more than the precision of a bucket.
+TEST_F(LatencyHistogramTest, Percentiles)
+{
+    LatencyHistogram lHistogram{};
+
+    EXPECT_EQ(lHistogram.GetPercentile(50), 0ns);
+
+    // 1us up to and including 1000us
+    for (int lCount = 1; lCount <= 1000; lCount++) {
+        lHistogram.Record(std::chrono::microseconds(lCount));
+    }
+
+    EXPECT_EQ(lHistogram.GetCount(), 1000);
+    EXPECT_EQ(lHistogram.GetMax(), 1000us);
+
+    const double                                 lPrecision{1.0 / LatencyHistogram_Constants::cSubBucketCount};
+    const std::vector<std::pair<double, double>> lExpectations{{50, 500e3}, {99, 990e3}, {99.9, 999e3}};
+    for (auto [lPercentile, lExpected] : lExpectations) {
+        const auto lValue{static_cast<double>(lHistogram.GetPercentile(lPercentile).count())};
+        EXPECT_GE(lValue, lExpected) << lPercentile;
+        EXPECT_LE(lValue, lExpected * (1 + lPrecision)) << lPercentile;
+    }
+
+    // Never more than what was recorded
+    EXPECT_EQ(lHistogram.GetPercentile(100), 1000us);
+
+    lHistogram.Reset();
+    EXPECT_EQ(lHistogram.GetCount(), 0);
+    EXPECT_EQ(lHistogram.GetPercentile(99), 0ns);
+}
+
+// Small values should be exact, negative ones count as 0 and huge ones should end up in the last bucket.
+TEST_F(LatencyHistogramTest, Limits)
+{
+    LatencyHistogram lHistogram{};
+
+    lHistogram.Record(-5ns);
+    lHistogram.Record(7ns, 2);
+    lHistogram.Record(24h);
+
+    EXPECT_EQ(lHistogram.GetCount(), 4);
+    EXPECT_EQ(lHistogram.GetPercentile(25), 0ns);
+    EXPECT_EQ(lHistogram.GetPercentile(75), 7ns);
+    EXPECT_EQ(lHistogram.GetMax(), 24h);
+    EXPECT_EQ(lHistogram.GetPercentile(100),
+              std::chrono::nanoseconds((1ULL << LatencyHistogram_Constants::cMaxValueBits) - 1));
+}
+
+// Recording from multiple threads at once should not lose anything.
+TEST_F(LatencyHistogramTest, ConcurrentRecording)
+{
+    constexpr unsigned int cAmountOfThreads{4};
+    constexpr unsigned int cAmountPerThread{100000};
+
+    LatencyHistogram         lHistogram{};
+    std::vector<std::thread> lThreads{};
+
+    for (unsigned int lThread = 0; lThread < cAmountOfThreads; lThread++) {
+        lThreads.emplace_back([&lHistogram, lThread] {
+            for (unsigned int lCount = 0; lCount < cAmountPerThread; lCount++) {
+                lHistogram.Record(std::chrono::nanoseconds(lCount * (lThread + 1)));
+            }
+        });
+    }
+
+    for (auto& lThread : lThreads) {
+        lThread.join();
+    }
+
+    EXPECT_EQ(lHistogram.GetCount(), cAmountOfThreads * cAmountPerThread);
+    EXPECT_EQ(lHistogram.GetMax(), std::chrono::nanoseconds((cAmountPerThread - 1) * cAmountOfThreads));
+}
+
+// Only enabled recording of packets with an arrival time should show up, under the active connection method.
+TEST_F(LatencyHistogramTest, Statistics)
+{
+    LatencyStatistics& lStatistics{LatencyStatistics::GetInstance()};
+    lStatistics.Reset();
+    lStatistics.SetConnectionMethod(LatencyStatistics_Constants::Plugin);
+
+    const auto lArrival{std::chrono::system_clock::now() - 2ms};
+    lStatistics.Record(LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Sent, lArrival);
+    EXPECT_EQ(lStatistics.ToString().find("Plugin"), std::string::npos);
+
+    lStatistics.SetEnabled(true);
+    lStatistics.Record(LatencyStatistics_Constants::ToXLinkKai, LatencyStatistics_Constants::Sent, lArrival, 3);
+    lStatistics.Record(LatencyStatistics_Constants::ToDevice,
+                       LatencyStatistics_Constants::Converted,
+                       std::chrono::system_clock::time_point{});
+    lStatistics.Record(LatencyStatistics_Constants::ToDevice, LatencyStatistics_Constants::Converted, nullptr);
+    lStatistics.SetEnabled(false);
+
+    const std::string lReport{lStatistics.ToString()};
+    EXPECT_NE(lReport.find("Plugin to XLink Kai, sent: "), std::string::npos) << lReport;
+    EXPECT_NE(lReport.find(" over 3 packets"), std::string::npos) << lReport;
+    EXPECT_EQ(lReport.find("to device"), std::string::npos) << lReport;
+
+    lStatistics.Reset();
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Logger_Test.cpp
+ * This file contains tests for the Logger class.
+ **/
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+
+using namespace std::chrono_literals;
+
+class LoggerTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        Logger::GetInstance().SetLogToDisk(false);
+        Logger::GetInstance().SetLogLevel(Logger::Level::ERROR);
+    }
+};
+
+// Only messages at or above the loglevel should get logged.
+TEST_F(LoggerTest, ShouldLog)
+{
+    Logger::GetInstance().SetLogLevel(Logger::Level::INFO);
+
+    EXPECT_FALSE(Logger::GetInstance().ShouldLog(Logger::Level::TRACE));
+    EXPECT_FALSE(Logger::GetInstance().ShouldLog(Logger::Level::DEBUG));
+    EXPECT_TRUE(Logger::GetInstance().ShouldLog(Logger::Level::INFO));
+    EXPECT_TRUE(Logger::GetInstance().ShouldLog(Logger::Level::ERROR));
+}
+
+// Messages from several threads should all end up in the log file, written by the writer thread.
+TEST_F(LoggerTest, WritesFromManyThreads)
+{
+    constexpr int cAmountOfThreads{4};
+    constexpr int cMessagesPerThread{50};
+
+    const std::string lOutputFileName{"../Tests/Output/LoggerTest.txt"};
+    Logger::GetInstance().Init(Logger::Level::DEBUG, true, lOutputFileName);
+
+    std::vector<std::thread> lThreads{};
+    for (int lThread = 0; lThread < cAmountOfThreads; lThread++) {
+        lThreads.emplace_back([lThread] {
+            for (int lCount = 0; lCount < cMessagesPerThread; lCount++) {
+                Logger::GetInstance().Log("Message " + std::to_string(lThread) + "-" + std::to_string(lCount),
+                                          Logger::Level::DEBUG);
+                Logger::GetInstance().Log("Filtered", Logger::Level::TRACE);
+            }
+        });
+    }
+
+    for (auto& lThread : lThreads) {
+        lThread.join();
+    }
+
+    // Writing happens in the background, give it some time
+    unsigned int lLines{0};
+    bool         lFiltered{false};
+    for (int lTries = 0; lTries < 200 && lLines < cAmountOfThreads * cMessagesPerThread; lTries++) {
+        std::this_thread::sleep_for(10ms);
+
+        std::ifstream lFile{lOutputFileName};
+        std::string   lLine{};
+        lLines = 0;
+        while (std::getline(lFile, lLine)) {
+            lLines += (lLine.find("Debug") != std::string::npos && lLine.find(":Message ") != std::string::npos);
+            lFiltered |= (lLine.find("Filtered") != std::string::npos);
+        }
+    }
+
+    EXPECT_EQ(lLines, cAmountOfThreads * cMessagesPerThread);
+    EXPECT_FALSE(lFiltered);
+}
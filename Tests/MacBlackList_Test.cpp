@@ -0,0 +1,111 @@
+/* Copyright (c) 2021 [Rick de Bondt] - MacBlackList_Test.cpp
+ * This file contains tests for the MacBlackList class.
+ **/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "MacBlackList.h"
+
+class MacBlackListTest : public ::testing::Test
+{};
+
+// Adding the same Mac address twice should only store it once.
+TEST_F(MacBlackListTest, DeduplicatedInserts)
+{
+    MacSet lSet{};
+
+    EXPECT_TRUE(lSet.Empty());
+    EXPECT_FALSE(lSet.Contains(0x0018f8293fb0));
+
+    EXPECT_TRUE(lSet.Insert(0x0018f8293fb0));
+    EXPECT_FALSE(lSet.Insert(0x0018f8293fb0));
+    EXPECT_EQ(lSet.Size(), 1);
+    EXPECT_TRUE(lSet.Contains(0x0018f8293fb0));
+
+    EXPECT_TRUE(lSet.Insert(0x00005e0001fe));
+    EXPECT_EQ(lSet.GetMacs(), (std::vector<uint64_t>{0x00005e0001fe, 0x0018f8293fb0}));
+
+    lSet.Clear();
+    EXPECT_TRUE(lSet.Empty());
+    EXPECT_FALSE(lSet.Contains(0x0018f8293fb0));
+}
+
+// Lots of Mac addresses from the same vendor should all be found after the set grows, and nothing else should be.
+TEST_F(MacBlackListTest, ManyMacAddresses)
+{
+    constexpr uint64_t cAmountOfMacs{5000};
+    constexpr uint64_t cVendor{0xd44b5e000000};
+
+    MacSet lSet{};
+    for (uint64_t lCount = 0; lCount < cAmountOfMacs; lCount++) {
+        ASSERT_TRUE(lSet.Insert(cVendor + lCount));
+    }
+
+    EXPECT_EQ(lSet.Size(), cAmountOfMacs);
+
+    for (uint64_t lCount = 0; lCount < cAmountOfMacs; lCount++) {
+        ASSERT_TRUE(lSet.Contains(cVendor + lCount));
+        ASSERT_FALSE(lSet.Contains(cVendor + cAmountOfMacs + lCount));
+    }
+}
+
+// The whitelist takes prevalence over the blacklist once it contains anything.
+TEST_F(MacBlackListTest, WhiteListPrevalence)
+{
+    MacBlackList lBlackList{};
+
+    lBlackList.AddToMacBlackList(0xd44b5e02ed20);
+    EXPECT_TRUE(lBlackList.IsMacBlackListed(0xd44b5e02ed20));
+    EXPECT_FALSE(lBlackList.IsMacAllowed(0xd44b5e02ed20));
+    EXPECT_TRUE(lBlackList.IsMacAllowed(0x00005e0001fe));
+
+    lBlackList.AddToMacWhiteList(0xd44b5e02ed20);
+    EXPECT_TRUE(lBlackList.IsMacAllowed(0xd44b5e02ed20));
+    EXPECT_FALSE(lBlackList.IsMacAllowed(0x00005e0001fe));
+
+    lBlackList.ClearMacWhiteList();
+    EXPECT_FALSE(lBlackList.IsMacAllowed(0xd44b5e02ed20));
+
+    std::vector<uint64_t> lNewBlackList{0x00005e0001fe, 0x00005e0001fe};
+    lBlackList.SetMacBlackList(lNewBlackList);
+    EXPECT_TRUE(lBlackList.IsMacAllowed(0xd44b5e02ed20));
+    EXPECT_FALSE(lBlackList.IsMacAllowed(0x00005e0001fe));
+}
+
+// Readers on other threads should always find everything that was added before, even while the set grows.
+TEST_F(MacBlackListTest, ConcurrentReaders)
+{
+    constexpr uint64_t cAmountOfMacs{20000};
+    constexpr uint64_t cVendor{0xd44b5e000000};
+
+    MacBlackList          lBlackList{};
+    std::atomic<uint64_t> lAdded{0};
+    std::atomic<bool>     lAllFound{true};
+
+    std::vector<std::thread> lReaders{};
+    for (int lCount = 0; lCount < 3; lCount++) {
+        lReaders.emplace_back([&] {
+            while (lAdded < cAmountOfMacs) {
+                const uint64_t lLastAdded{lAdded};
+                if (lLastAdded > 0 && lBlackList.IsMacAllowed(cVendor + lLastAdded - 1)) {
+                    lAllFound = false;
+                }
+            }
+        });
+    }
+
+    for (uint64_t lCount = 0; lCount < cAmountOfMacs; lCount++) {
+        lBlackList.AddToMacBlackList(cVendor + lCount);
+        lAdded++;
+    }
+
+    for (auto& lReader : lReaders) {
+        lReader.join();
+    }
+
+    EXPECT_TRUE(lAllFound);
+}
@@ -200,6 +200,37 @@ TEST_F(PacketHandlingTest, PromiscuousToMonitor)
 }
 
 
+// Capture filters should only let through what the handlers would not drop anyway.
+TEST_F(PacketHandlingTest, ConstructCaptureFilters)
+{
+    EXPECT_EQ(ConstructEthernetFilter({}, {}), "");
+    EXPECT_EQ(ConstructEthernetFilter({}, {0xb03f29f81800}), "not (ether src 00:18:f8:29:3f:b0)");
+    EXPECT_EQ(ConstructEthernetFilter({Net_Constants::cPSPEtherType, Net_Constants::Arp::cEtherType},
+                                      {0xb03f29f81800, 0xa6df695e4bd4}),
+              "(ether proto 0x88c8 or ether proto 0x0806) and not (ether src 00:18:f8:29:3f:b0 or ether src "
+              "d4:4b:5e:69:df:a6)");
+
+    // Without a network to listen to only beacons are needed
+    EXPECT_EQ(Construct80211Filter(0, {}, {}), "(type mgt subtype beacon)");
+    EXPECT_EQ(Construct80211Filter(0xc4c1a85e4bd4, {0xb03f29f81800}, {}),
+              "(type mgt subtype beacon and not (wlan addr2 00:18:f8:29:3f:b0)) or (type data and wlan addr3 "
+              "d4:4b:5e:a8:c1:c4 and not (wlan addr2 00:18:f8:29:3f:b0)) or (type ctl subtype ack and (wlan addr1 "
+              "00:18:f8:29:3f:b0))");
+
+    // The whitelist takes prevalence over the blacklist
+    EXPECT_EQ(Construct80211Filter(0xc4c1a85e4bd4, {0xb03f29f81800}, {0xa6df695e4bd4}),
+              "(type mgt subtype beacon and (wlan addr2 d4:4b:5e:69:df:a6)) or (type data and wlan addr3 "
+              "d4:4b:5e:a8:c1:c4 and (wlan addr2 d4:4b:5e:69:df:a6)) or (type ctl subtype ack and (wlan addr1 "
+              "00:18:f8:29:3f:b0))");
+
+    // Too many Mac addresses are left to userspace instead of making the filter huge
+    std::vector<uint64_t> lBlackList{};
+    for (uint64_t lCount = 0; lCount < 100; lCount++) {
+        lBlackList.push_back(0xd44b5e000000 + lCount);
+    }
+    EXPECT_EQ(ConstructEthernetFilter({Net_Constants::cPSPEtherType}, lBlackList), "(ether proto 0x88c8)");
+}
+
 // What we should be seeing after this test is acknowledgements added to 169.254.93.107. With destination mac:
 // d4:4b:5e:69:df:a6. It should have copied the wireless parameters from an ack packet with the following destination
 // address: d4:4b:5e:a8:c1:c4
@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 [Rick de Bondt] - PacketRing_Test.cpp
+ * This file contains tests for the PacketRing class.
+ **/
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "PacketRing.h"
+
+class PacketRingTest : public ::testing::Test
+{};
+
+// Packets should come out in the same order they went in, along with their arrival time.
+TEST_F(PacketRingTest, PushAndPop)
+{
+    PacketRing<4, 16>                           lRing{};
+    const std::chrono::system_clock::time_point lArrival{std::chrono::system_clock::now()};
+
+    EXPECT_TRUE(lRing.Front().empty());
+
+    ASSERT_TRUE(lRing.Push("first"));
+    ASSERT_TRUE(lRing.Push("second", lArrival));
+
+    EXPECT_EQ(lRing.Front(), "first");
+    EXPECT_EQ(lRing.FrontArrival(), std::chrono::system_clock::time_point{});
+    lRing.Pop();
+    EXPECT_EQ(lRing.Front(), "second");
+    EXPECT_EQ(lRing.FrontArrival(), lArrival);
+    lRing.Pop();
+    EXPECT_TRUE(lRing.Front().empty());
+    EXPECT_EQ(lRing.GetDroppedCount(), 0);
+}
+
+// When the ring is full or a packet does not fit a slot, the packet should be dropped and counted.
+TEST_F(PacketRingTest, DropsWhenFull)
+{
+    PacketRing<2, 8> lRing{};
+
+    ASSERT_TRUE(lRing.Push("one"));
+    ASSERT_TRUE(lRing.Push("two"));
+    EXPECT_FALSE(lRing.Push("three"));
+    EXPECT_FALSE(lRing.Push("much too big for a slot"));
+    EXPECT_EQ(lRing.GetDroppedCount(), 2);
+
+    // Empty packets are ignored, not dropped
+    EXPECT_FALSE(lRing.Push(""));
+    EXPECT_EQ(lRing.GetDroppedCount(), 2);
+
+    // Making room should allow pushing again
+    lRing.Pop();
+    EXPECT_TRUE(lRing.Push("three"));
+    EXPECT_EQ(lRing.Front(), "two");
+}
+
+// A producer and consumer on different threads should see every packet in order, as long as nothing is dropped.
+TEST_F(PacketRingTest, ProducerConsumer)
+{
+    constexpr unsigned int cAmountOfPackets{10000};
+
+    PacketRing<64, 16> lRing{};
+    unsigned int       lReceived{0};
+    bool               lInOrder{true};
+
+    std::thread lConsumer{[&] {
+        while (lReceived < cAmountOfPackets) {
+            std::string_view lData{lRing.Front()};
+            if (!lData.empty()) {
+                lInOrder &= (lData == std::to_string(lReceived));
+                lReceived++;
+                lRing.Pop();
+            } else {
+                lRing.Wait();
+            }
+        }
+    }};
+
+    for (unsigned int lCount = 0; lCount < cAmountOfPackets; lCount++) {
+        // Keep retrying so nothing gets lost, the drops are tested above
+        while (!lRing.Push(std::to_string(lCount))) {
+            std::this_thread::yield();
+        }
+    }
+
+    lConsumer.join();
+
+    EXPECT_EQ(lReceived, cAmountOfPackets);
+    EXPECT_TRUE(lInOrder);
+}
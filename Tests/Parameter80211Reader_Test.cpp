@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Parameter80211Reader_Test.cpp
+ * This file contains tests for the Parameter80211Reader class.
+ **/
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Parameter80211Reader.h"
+
+class Parameter80211ReaderTest : public ::testing::Test
+{
+protected:
+    /**
+     * Builds a beacon without physical device header.
+     * @param aSSID - SSID to put in the beacon.
+     * @param aChannel - Channel to put in the beacon.
+     * @param aTimestamp - Timestamp to put in the fixed parameters.
+     * @return the beacon.
+     */
+    static std::string Beacon(std::string_view aSSID, char aChannel, char aTimestamp)
+    {
+        std::string lBeacon(Net_80211_Constants::cFixedParameterTypeSSIDIndex, '\0');
+        lBeacon.at(0)  = '\x80';
+        lBeacon.at(24) = aTimestamp;
+
+        lBeacon += std::string{'\x00', static_cast<char>(aSSID.size())} + std::string(aSSID);
+        lBeacon += std::string{"\x01\x02\x82\x84", 4};
+        lBeacon += std::string{"\x03\x01", 2} + aChannel;
+        lBeacon += std::string{"\x06\x02\x00\x00", 4};
+        return lBeacon;
+    }
+
+    Parameter80211Reader mReader{nullptr};
+};
+
+// Beacons should be parsed, and parsed again when their information changes, but not when only the timestamp changes.
+TEST_F(Parameter80211ReaderTest, CachedBeacon)
+{
+    mReader.Update(Beacon("XLinkNetwork", 6, 1), 0x0018f8293fb0);
+
+    EXPECT_EQ(mReader.GetSSID(), "XLinkNetwork");
+    EXPECT_EQ(mReader.GetMaxRate(), 0x84);
+    EXPECT_EQ(mReader.GetFrequency(), 2437);
+    EXPECT_TRUE(mReader.GetIsAdhoc());
+
+    // Another network in between should not affect the first
+    mReader.Update(Beacon("Other", 1, 1), 0xd44b5e02ed20);
+    EXPECT_EQ(mReader.GetSSID(), "Other");
+    EXPECT_EQ(mReader.GetFrequency(), 2412);
+
+    mReader.Update(Beacon("XLinkNetwork", 6, 2), 0x0018f8293fb0);
+    EXPECT_EQ(mReader.GetSSID(), "XLinkNetwork");
+    EXPECT_EQ(mReader.GetFrequency(), 2437);
+
+    mReader.Update(Beacon("XLinkNetwork", 11, 3), 0x0018f8293fb0);
+    EXPECT_EQ(mReader.GetFrequency(), 2462);
+
+    const auto lNetworks{mReader.GetAdhocNetworks()};
+    ASSERT_EQ(lNetworks.size(), 2);
+    EXPECT_EQ(lNetworks.at(0).BSSID, 0x0018f8293fb0);
+    EXPECT_EQ(lNetworks.at(0).SSID, "XLinkNetwork");
+    EXPECT_EQ(lNetworks.at(0).Frequency, 2462);
+}
+
+// The cache should not grow past its maximum size, the network seen longest ago should be forgotten.
+TEST_F(Parameter80211ReaderTest, CacheSize)
+{
+    for (uint64_t lCount = 0; lCount <= Parameter80211Reader_Constants::cBeaconCacheSize; lCount++) {
+        mReader.Update(Beacon("Network" + std::to_string(lCount), 6, 1), lCount + 1);
+    }
+
+    const auto lNetworks{mReader.GetAdhocNetworks()};
+    ASSERT_EQ(lNetworks.size(), Parameter80211Reader_Constants::cBeaconCacheSize);
+    for (const auto& lNetwork : lNetworks) {
+        EXPECT_NE(lNetwork.BSSID, 1);
+    }
+}
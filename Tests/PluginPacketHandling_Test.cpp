@@ -2,6 +2,10 @@
  * This file contains tests for the PacketConverter class.
  **/
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -363,3 +367,121 @@ TEST_F(PluginPacketHandlingTest, NoBroadcastMacToBeUsedWhenNormalPacket)
     // Testing
     lPSPPluginDevice.ReadCallback(lPCapReader.GetData(), lPCapReader.GetHeader());
 }
+
+// The kernel filter should only let PSP plugin frames through, and follow the blacklist. It may only be changed from
+// the receiving thread, since that owns the capture handle.
+TEST_F(PluginPacketHandlingTest, FilterFollowsBlackList)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<IWifiInterfaceMock>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPSPPluginDevice         lPSPPluginDevice{false,
+                                             WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                             nullptr,
+                                             std::make_shared<HandlerPSPPlugin>(),
+                                             std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    const std::thread::id lTestThread{std::this_thread::get_id()};
+    std::atomic_bool      lUpdatedOnReceiver{false};
+
+    EXPECT_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdapterMacAddress)
+        .WillOnce(Return(0xb03f29f81800));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+    ON_CALL(*lPCapWrapperMock, GetSelectableFd()).WillByDefault(Return(-1));
+
+    EXPECT_CALL(*lPCapWrapperMock,
+                SetFilter(std::string_view{"(ether proto 0x88c8) and not (ether src 00:18:f8:29:3f:b0)"}))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lPCapWrapperMock,
+                SetFilter(std::string_view{
+                    "(ether proto 0x88c8) and not (ether src 66:55:44:33:22:11 or ether src 00:18:f8:29:3f:b0)"}))
+        .WillOnce([&](std::string_view) {
+            lUpdatedOnReceiver = std::this_thread::get_id() != lTestThread;
+            return 0;
+        });
+
+    // Blacklisted sources, the adapter included, should stay with the kernel stack where the backend supports that
+    EXPECT_CALL(*lPCapWrapperMock, SetPassedSources(std::vector<uint64_t>{0xb03f29f81800})).WillOnce(Return(0));
+    EXPECT_CALL(*lPCapWrapperMock, SetPassedSources(std::vector<uint64_t>{0x112233445566, 0xb03f29f81800}))
+        .WillOnce(Return(0));
+
+    lPSPPluginDevice.Open("wlan0", lSSIDFilter, lWifiInterface);
+    lPSPPluginDevice.BlackList(0x112233445566);
+    ASSERT_TRUE(lPSPPluginDevice.StartReceiverThread());
+
+    for (int lTries = 0; lTries < 200 && !lUpdatedOnReceiver; lTries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(lUpdatedOnReceiver);
+
+    lPSPPluginDevice.Close();
+}
+
+// Blacklisting a Mac address that is already blacklisted should not rebuild the capture filter.
+TEST_F(PluginPacketHandlingTest, FilterOnlyUpdatedForNewMacs)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<IWifiInterfaceMock>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPSPPluginDevice         lPSPPluginDevice{false,
+                                             WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                             nullptr,
+                                             std::make_shared<HandlerPSPPlugin>(),
+                                             std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    std::atomic<int> lFilterCount{0};
+
+    EXPECT_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdapterMacAddress)
+        .WillOnce(Return(0xb03f29f81800));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+    ON_CALL(*lPCapWrapperMock, GetSelectableFd()).WillByDefault(Return(-1));
+    ON_CALL(*lPCapWrapperMock, SetFilter(_)).WillByDefault([&](std::string_view) {
+        lFilterCount++;
+        return 0;
+    });
+
+    // Once on open, with the adapter blacklisted
+    lPSPPluginDevice.Open("wlan0", lSSIDFilter, lWifiInterface);
+    EXPECT_EQ(lFilterCount, 1);
+
+    lPSPPluginDevice.BlackList(0x112233445566);
+    ASSERT_TRUE(lPSPPluginDevice.StartReceiverThread());
+
+    for (int lTries = 0; lTries < 200 && lFilterCount < 2; lTries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(lFilterCount, 2);
+
+    // Nothing new, so the filter should stay as it is
+    lPSPPluginDevice.BlackList(0x112233445566);
+    lPSPPluginDevice.BlackList(0xb03f29f81800);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(lFilterCount, 2);
+
+    lPSPPluginDevice.Close();
+}
+
+// A frame that can't be converted should not end up in the send queue, where it would make the whole batch fail.
+TEST_F(PluginPacketHandlingTest, UnconvertibleFrameNotQueued)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<IWifiInterfaceMock>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPSPPluginDevice         lPSPPluginDevice{false,
+                                             WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                             nullptr,
+                                             std::make_shared<HandlerPSPPlugin>(),
+                                             std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    EXPECT_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdapterMacAddress)
+        .WillOnce(Return(0xb03f29f81800));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+
+    EXPECT_CALL(*lPCapWrapperMock, SendPacket(_)).Times(0);
+    EXPECT_CALL(*lPCapWrapperMock, SendBatch(_)).Times(0);
+
+    lPSPPluginDevice.Open("wlan0", lSSIDFilter, lWifiInterface);
+
+    EXPECT_FALSE(lPSPPluginDevice.Queue(std::string_view{"\x01\x02\x03", 3}));
+    EXPECT_TRUE(lPSPPluginDevice.Flush());
+}
@@ -2,6 +2,12 @@
  * This file contains tests for the WirelessPromiscuousDevice class.
  **/
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -15,6 +21,7 @@
 using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Return;
+using ::testing::SetArgPointee;
 using ::testing::WithArg;
 
 class PromiscuousPacketHandlingTest : public ::testing::Test
@@ -518,3 +525,136 @@ TEST_F(PromiscuousPacketHandlingTest, NormalPacketHandlingDeviceSide)
     lPCapExpectedReader.Close();
     lPromiscuousDevice.Close();
 }
+
+// Queued packets should only be injected on Flush, in a single batch, a plain Send should still go out on its own.
+TEST_F(PromiscuousPacketHandlingTest, BatchedInjection)
+{
+    auto                      lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPromiscuousDevice lPromiscuousDevice{false,
+                                                 WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                                 nullptr,
+                                                 std::make_shared<Handler8023>(),
+                                                 std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    std::vector<std::string> lPackets{};
+    for (char lCount = 0; lCount < 3; lCount++) {
+        lPackets.emplace_back(std::string{"\xff\xff\xff\xff\xff\xff\x01\x02\x03\x04\x05\x06\x88\xc8", 14} + lCount);
+    }
+
+    std::vector<std::string> lOutputPackets{};
+
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+
+    // Nothing should be sent while queueing
+    EXPECT_CALL(*lPCapWrapperMock, SendPacket(_)).Times(0);
+    EXPECT_CALL(*lPCapWrapperMock, SendBatch(_)).Times(0);
+
+    for (auto& lPacket : lPackets) {
+        ASSERT_TRUE(lPromiscuousDevice.Queue(lPacket));
+    }
+
+    ::testing::Mock::VerifyAndClearExpectations(lPCapWrapperMock.get());
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+
+    EXPECT_CALL(*lPCapWrapperMock, SendBatch(_))
+        .WillOnce(WithArg<0>([&](std::span<const std::string> aPackets) {
+            lOutputPackets.assign(aPackets.begin(), aPackets.end());
+            return static_cast<int>(aPackets.size());
+        }));
+
+    ASSERT_TRUE(lPromiscuousDevice.Flush());
+    EXPECT_EQ(lOutputPackets, lPackets);
+
+    // The queue should be empty again, so a single packet goes out on its own
+    EXPECT_CALL(*lPCapWrapperMock, SendPacket(std::string_view{lPackets.front()})).WillOnce(Return(0));
+    ASSERT_TRUE(lPromiscuousDevice.Send(lPackets.front()));
+}
+
+// When pcap offers a selectable file descriptor, packets should only be dispatched once it becomes readable, and
+// closing the device should wake the receiver thread up immediately.
+TEST_F(PromiscuousPacketHandlingTest, EventDrivenReceive)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<IWifiInterfaceMock>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPromiscuousDevice       lPromiscuousDevice{false,
+                                                       WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                                       nullptr,
+                                                       std::make_shared<Handler8023>(),
+                                                       std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    // A pipe stands in for the pcap socket
+    std::array<int, 2> lPipe{};
+    ASSERT_EQ(pipe(lPipe.data()), 0);
+
+    std::atomic<int> lDispatchCount{0};
+
+    EXPECT_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdapterMacAddress)
+        .WillOnce(Return(0xb03f29f81800));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+    ON_CALL(*lPCapWrapperMock, GetSelectableFd()).WillByDefault(Return(lPipe.at(0)));
+    EXPECT_CALL(*lPCapWrapperMock, SetNonBlock(1)).WillOnce(Return(0));
+    EXPECT_CALL(*lPCapWrapperMock, Dispatch(_, _, _)).WillRepeatedly([&](int, pcap_handler, unsigned char*) {
+        char lByte{};
+        read(lPipe.at(0), &lByte, 1);
+        lDispatchCount++;
+        return 1;
+    });
+
+    lPromiscuousDevice.Open("wlan0", lSSIDFilter, lWifiInterface);
+    ASSERT_TRUE(lPromiscuousDevice.StartReceiverThread());
+
+    // Nothing is ready yet, so nothing should be dispatched
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(lDispatchCount, 0);
+
+    ASSERT_EQ(write(lPipe.at(1), "abc", 3), 3);
+    for (int lTries = 0; lTries < 200 && lDispatchCount < 3; lTries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(lDispatchCount, 3);
+
+    // Without autoconnect the receiver thread waits indefinitely, so this only returns if closing wakes it up
+    lPromiscuousDevice.Close();
+
+    close(lPipe.at(0));
+    close(lPipe.at(1));
+}
+
+// The configured capture buffer size should be set before activating, and the statistics collected on close should be
+// available afterwards.
+TEST_F(PromiscuousPacketHandlingTest, CaptureStatistics)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<IWifiInterfaceMock>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPromiscuousDevice       lPromiscuousDevice{false,
+                                                       WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                                       nullptr,
+                                                       std::make_shared<Handler8023>(),
+                                                       std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    pcap_stat lStatistics{};
+    lStatistics.ps_recv   = 1000;
+    lStatistics.ps_drop   = 12;
+    lStatistics.ps_ifdrop = 3;
+
+    EXPECT_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdapterMacAddress)
+        .WillOnce(Return(0xb03f29f81800));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+    {
+        ::testing::InSequence lSequence{};
+        EXPECT_CALL(*lPCapWrapperMock, SetBufferSize(4 * 1024 * 1024)).WillOnce(Return(0));
+        EXPECT_CALL(*lPCapWrapperMock, Activate()).WillOnce(Return(0));
+    }
+    EXPECT_CALL(*lPCapWrapperMock, GetStatistics(_)).WillOnce(DoAll(SetArgPointee<0>(lStatistics), Return(0)));
+
+    lPromiscuousDevice.SetCaptureBufferSize(4 * 1024 * 1024);
+    ASSERT_TRUE(lPromiscuousDevice.Open("wlan0", lSSIDFilter, lWifiInterface));
+    lPromiscuousDevice.Close();
+
+    const IPCapDevice_Constants::CaptureStatistics lCaptureStatistics{lPromiscuousDevice.GetCaptureStatistics()};
+    EXPECT_EQ(lCaptureStatistics.Received, 1000);
+    EXPECT_EQ(lCaptureStatistics.Dropped, 12);
+    EXPECT_EQ(lCaptureStatistics.InterfaceDropped, 3);
+}
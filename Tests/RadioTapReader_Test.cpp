@@ -0,0 +1,80 @@
+/* Copyright (c) 2021 [Rick de Bondt] - RadioTapReader_Test.cpp
+ * This file contains tests for the RadioTapReader class.
+ **/
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "RadioTapReader.h"
+
+class RadioTapReaderTest : public ::testing::Test
+{};
+
+// Only the fields that are asked for should be decoded, the rest keeps its default.
+TEST_F(RadioTapReaderTest, DecodeRequestedFields)
+{
+    // Present: TSFT, Flags, Rate, Channel, MCS
+    const std::string lHeader{"\x00\x00\x19\x00\x0f\x00\x08\x00"  // Header, length 25
+                              "\x01\x02\x03\x04\x05\x06\x07\x08"  // TSFT
+                              "\x12"                              // Flags, FCS available
+                              "\x16"                              // Rate
+                              "\x85\x09\xa0\x00"                  // Channel 2437, flags
+                              "\x07\x20\x05",                     // MCS
+                              25};
+
+    RadioTapReader lReader{};
+    lReader.FillRadioTapParameters(lHeader, RadioTap_Constants::cFlagsField);
+
+    EXPECT_EQ(lReader.GetLength(), 25);
+    EXPECT_EQ(lReader.GetFlags(), 0x12);
+    EXPECT_EQ(lReader.GetDataRate(), RadioTap_Constants::cRateFlags);
+    EXPECT_EQ(lReader.GetFrequency(), RadioTap_Constants::cChannel);
+    EXPECT_EQ(lReader.GetMCSInfo(), 0);
+
+    lReader.FillRadioTapParameters(lHeader);
+
+    EXPECT_EQ(lReader.GetFlags(), 0x12);
+    EXPECT_EQ(lReader.GetDataRate(), 0x16);
+    EXPECT_EQ(lReader.GetFrequency(), 2437);
+    EXPECT_EQ(lReader.GetChannelFlags(), 0x00a0);
+    EXPECT_EQ(lReader.GetKnownMCSInfo(), 0x07);
+    EXPECT_EQ(lReader.GetMCSFlags(), 0x20);
+    EXPECT_EQ(lReader.GetMCSInfo(), 0x05);
+}
+
+// Fields should be aligned to their own alignment, XChannel is 4 byte aligned.
+TEST_F(RadioTapReaderTest, FieldAlignment)
+{
+    // Present: Flags, XChannel, MCS
+    const std::string lHeader{"\x00\x00\x17\x00\x02\x00\x0c\x00"  // Header, length 23
+                              "\x10"                              // Flags
+                              "\x00\x00\x00"                      // Padding
+                              "\x00\x00\x00\x00\x6c\x09\x01\x14"  // XChannel
+                              "\x07\x20\x05",                     // MCS
+                              23};
+
+    RadioTapReader lReader{};
+    lReader.FillRadioTapParameters(lHeader);
+
+    EXPECT_EQ(lReader.GetFlags(), 0x10);
+    EXPECT_EQ(lReader.GetKnownMCSInfo(), 0x07);
+    EXPECT_EQ(lReader.GetMCSFlags(), 0x20);
+    EXPECT_EQ(lReader.GetMCSInfo(), 0x05);
+}
+
+// A header that claims fields it does not have should not be read past its length.
+TEST_F(RadioTapReaderTest, TruncatedHeader)
+{
+    // Present: TSFT, Flags, but only room for the TSFT
+    const std::string lHeader{"\x00\x00\x10\x00\x03\x00\x00\x00"
+                              "\x01\x02\x03\x04\x05\x06\x07\x08"
+                              "\x12",
+                              17};
+
+    RadioTapReader lReader{};
+    lReader.FillRadioTapParameters(lHeader);
+
+    EXPECT_EQ(lReader.GetLength(), 16);
+    EXPECT_EQ(lReader.GetFlags(), RadioTap_Constants::cFlags);
+}
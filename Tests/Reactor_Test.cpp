@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 [Rick de Bondt] - Reactor_Test.cpp
+ * This file contains tests for the Reactor class.
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "Reactor.h"
+
+class ReactorTest : public ::testing::Test
+{};
+
+#ifdef __linux__
+// Readable callbacks and timers should be called from the reactor thread, and never again after stopping.
+TEST_F(ReactorTest, ReadableAndTimer)
+{
+    std::array<int, 2> lPipe{};
+    ASSERT_EQ(pipe(lPipe.data()), 0);
+
+    Reactor          lReactor{};
+    std::atomic<int> lReadCount{0};
+    std::atomic<int> lTimerCount{0};
+    std::thread::id  lReactorThread{};
+
+    ASSERT_TRUE(lReactor.AddReadable(lPipe.at(0), [&] {
+        char lCharacter{};
+        if (read(lPipe.at(0), &lCharacter, 1) == 1) {
+            lReactorThread = std::this_thread::get_id();
+            lReadCount++;
+        }
+    }));
+    lReactor.AddTimer(std::chrono::milliseconds(5), [&] { lTimerCount++; });
+
+    ASSERT_TRUE(lReactor.Start());
+
+    ASSERT_EQ(write(lPipe.at(1), "a", 1), 1);
+    ASSERT_EQ(write(lPipe.at(1), "b", 1), 1);
+
+    // Wait for the data and a few timer ticks
+    for (int lTries = 0; lTries < 1000 && (lReadCount < 2 || lTimerCount < 3); lTries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    lReactor.Stop();
+
+    EXPECT_EQ(lReadCount, 2);
+    EXPECT_GE(lTimerCount, 3);
+    EXPECT_NE(lReactorThread, std::this_thread::get_id());
+
+    // Nothing should be dispatched anymore
+    const int lTimerCountAtStop{lTimerCount};
+    ASSERT_EQ(write(lPipe.at(1), "c", 1), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(lReadCount, 2);
+    EXPECT_EQ(lTimerCount, lTimerCountAtStop);
+
+    close(lPipe.at(0));
+    close(lPipe.at(1));
+}
+
+// A removed file descriptor should not be dispatched anymore.
+TEST_F(ReactorTest, RemoveReadable)
+{
+    std::array<int, 2> lPipe{};
+    ASSERT_EQ(pipe(lPipe.data()), 0);
+
+    Reactor          lReactor{};
+    std::atomic<int> lReadCount{0};
+
+    ASSERT_TRUE(lReactor.AddReadable(lPipe.at(0), [&] { lReadCount++; }));
+    lReactor.RemoveReadable(lPipe.at(0));
+
+    ASSERT_TRUE(lReactor.Start());
+    ASSERT_EQ(write(lPipe.at(1), "a", 1), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lReactor.Stop();
+
+    EXPECT_EQ(lReadCount, 0);
+
+    close(lPipe.at(0));
+    close(lPipe.at(1));
+}
+#endif
@@ -0,0 +1,144 @@
+/* Copyright (c) 2021 [Rick de Bondt] - TPacketWrapperLinux_Test.cpp
+ * This file contains tests for the TPacketWrapper class, these need permission to open a packet socket on loopback.
+ **/
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "TPacketWrapperLinux.h"
+
+namespace
+{
+    // Local experimental ethertype, nothing else on loopback uses it
+    constexpr std::string_view cHeader{"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x88\xb5", 14};
+
+    std::string MakeFrame(int aIndex)
+    {
+        return std::string(cHeader) + "TPacketWrapperTest" + std::to_string(aIndex);
+    }
+
+    bool IsTestFrame(std::string_view aFrame)
+    {
+        return aFrame.substr(0, cHeader.size()) == cHeader;
+    }
+}  // namespace
+
+class TPacketWrapperTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+        mWrapper.Create("lo", lErrorBuffer.data());
+        mWrapper.SetTimeOut(10);
+        mWrapper.SetDirection(PcapDirection::DIR_IN);
+        if (mWrapper.Activate() != 0) {
+            GTEST_SKIP() << "Can't open a packet socket on loopback: " << mWrapper.GetError();
+        }
+    }
+
+    std::vector<std::string> ReceiveTestFrames(size_t aAmount)
+    {
+        std::vector<std::string> lFrames{};
+
+        auto lCallback = [](unsigned char* aFrames, const pcap_pkthdr* aHeader, const unsigned char* aPacket) {
+            std::string_view lFrame{reinterpret_cast<const char*>(aPacket), aHeader->caplen};
+            if (IsTestFrame(lFrame)) {
+                reinterpret_cast<std::vector<std::string>*>(aFrames)->emplace_back(lFrame);
+            }
+        };
+
+        // Blocks are handed over on timeout, so this should not take more than a few tries
+        for (int lTries = 0; lTries < 100 && lFrames.size() < aAmount; lTries++) {
+            mWrapper.Dispatch(-1, lCallback, reinterpret_cast<unsigned char*>(&lFrames));
+        }
+
+        return lFrames;
+    }
+
+    TPacketWrapper mWrapper{};
+};
+
+// Frames sent through the send ring should come back through the receive ring exactly once, in order.
+TEST_F(TPacketWrapperTest, SendAndReceive)
+{
+    ASSERT_EQ(mWrapper.GetDatalink(), DLT_EN10MB);
+
+    std::vector<std::string> lSent{MakeFrame(0), MakeFrame(1), MakeFrame(2)};
+    ASSERT_EQ(mWrapper.SendBatch(lSent), 3);
+
+    std::vector<std::string> lReceived{ReceiveTestFrames(lSent.size())};
+    EXPECT_EQ(lReceived, lSent);
+
+    // Outgoing copies are filtered, so nothing else should show up
+    EXPECT_TRUE(ReceiveTestFrames(1).empty());
+
+    // Nothing should have been lost, and the ring can't be resized anymore
+    pcap_stat lStatistics{};
+    ASSERT_EQ(mWrapper.GetStatistics(&lStatistics), 0);
+    EXPECT_GE(lStatistics.ps_recv, lSent.size());
+    EXPECT_EQ(lStatistics.ps_drop, 0);
+    EXPECT_EQ(mWrapper.SetBufferSize(1024 * 1024), PCAP_ERROR_ACTIVATED);
+}
+
+// A batch that doesn't fit in the send ring should go out in multiple flushes.
+TEST_F(TPacketWrapperTest, LargeBatch)
+{
+    std::vector<std::string> lSent{};
+    for (unsigned int lCount = 0; lCount < TPacketWrapper_Constants::cSendFramesPerBlock *
+                                               (TPacketWrapper_Constants::cSendBlockCount + 1);
+         lCount++) {
+        lSent.emplace_back(MakeFrame(static_cast<int>(lCount)));
+    }
+
+    EXPECT_EQ(mWrapper.SendBatch(lSent), static_cast<int>(lSent.size()));
+    EXPECT_EQ(mWrapper.SendPacket(std::string(TPacketWrapper_Constants::cSendFrameSize, 'x')), PCAP_ERROR);
+}
+
+// NextEx should return packets one by one, and 0 when nothing arrives in time.
+TEST_F(TPacketWrapperTest, NextEx)
+{
+    ASSERT_EQ(mWrapper.SendPacket(MakeFrame(0)), 0);
+
+    pcap_pkthdr*         lHeader{nullptr};
+    const unsigned char* lData{nullptr};
+    bool                 lFound{false};
+    for (int lTries = 0; lTries < 100 && !lFound; lTries++) {
+        if (mWrapper.NextEx(&lHeader, &lData) == 1) {
+            lFound = IsTestFrame({reinterpret_cast<const char*>(lData), lHeader->caplen});
+        }
+    }
+
+    ASSERT_TRUE(lFound);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(lData), lHeader->caplen), MakeFrame(0));
+
+    mWrapper.SetNonBlock(1);
+    EXPECT_EQ(mWrapper.NextEx(&lHeader, &lData), 0);
+}
+
+// BreakLoop should wake up a Dispatch that is waiting forever.
+TEST_F(TPacketWrapperTest, BreakLoop)
+{
+    mWrapper.Close();
+    std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+    mWrapper.Create("lo", lErrorBuffer.data());
+    mWrapper.SetTimeOut(0);
+    ASSERT_EQ(mWrapper.Activate(), 0);
+
+    int         lResult{0};
+    std::thread lThread{[&] {
+        auto lCallback = [](unsigned char*, const pcap_pkthdr*, const unsigned char*) {};
+        while (lResult >= 0) {
+            lResult = mWrapper.Dispatch(-1, lCallback, nullptr);
+        }
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    mWrapper.BreakLoop();
+    lThread.join();
+
+    EXPECT_EQ(lResult, PCAP_ERROR_BREAK);
+}
@@ -22,6 +22,9 @@ TEST_F(WindowModelTest, SaveModel)
     mWindowModel.mAutoDiscoverXLinkKaiInstance = true;
     mWindowModel.mChannel                      = "6";
     mWindowModel.mConnectionMethod             = WindowModel_Constants::Monitor;
+    mWindowModel.mCaptureBackend               = WindowModel_Constants::TPacket;
+    mWindowModel.mCaptureBufferSizeKiB         = "4096";
+    mWindowModel.mTPacketBlockSizeKiB          = "256";
 
     ASSERT_TRUE(mWindowModel.SaveToFile("../Tests/Output/config.txt"));
     std::ifstream lOutputFile;
@@ -68,4 +71,8 @@ TEST_F(WindowModelTest, LoadModel)
     EXPECT_EQ(mWindowModel.mXLinkPort, WindowModel_Constants::cDefaultXLinkPort);
     EXPECT_EQ(mWindowModel.mAcknowledgeDataFrames, WindowModel_Constants::cDefaultAcknowledgeDataFrames);
     EXPECT_EQ(mWindowModel.mOnlyAcceptFromMac, WindowModel_Constants::cDefaultOnlyAcceptFromMac);
+    EXPECT_EQ(mWindowModel.mCaptureBackend, WindowModel_Constants::TPacket);
+    EXPECT_EQ(mWindowModel.mCaptureBufferSizeKiB, "4096");
+    EXPECT_EQ(mWindowModel.mTPacketBlockSizeKiB, "256");
+    EXPECT_EQ(mWindowModel.mTPacketTimeOutMs, WindowModel_Constants::cDefaultTPacketTimeOutMs);
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+/* Copyright (c) 2021 [Rick de Bondt] - XLinkKaiConnection_Test.cpp
+ * This file contains tests for the XLinkKaiConnection class.
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "IPCapDeviceMock.h"
+#include "XLinkKaiConnection.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+using namespace boost::asio;
+using namespace std::chrono_literals;
+
+class XLinkKaiConnectionTest : public ::testing::Test
+{
+protected:
+    /**
+     * Receives a single datagram on the fake XLink Kai socket.
+     * @return the datagram as string.
+     */
+    std::string ReceiveDatagram()
+    {
+        std::array<char, XLinkKai_Constants::cMaxLength> lBuffer{};
+        size_t lBytesReceived{mFakeXLinkKai.receive_from(buffer(lBuffer), mXLHAEndpoint)};
+        return {lBuffer.data(), lBytesReceived};
+    }
+
+    /**
+     * Sends a datagram from the fake XLink Kai socket to the connection.
+     * @param aData - Data to send.
+     */
+    void SendDatagram(std::string_view aData)
+    {
+        mFakeXLinkKai.send_to(buffer(aData.data(), aData.size()), mXLHAEndpoint);
+    }
+
+    /**
+     * Opens the connection and does the connect handshake with the fake XLink Kai.
+     */
+    void Connect()
+    {
+        ASSERT_TRUE(mConnection.Open("127.0.0.1", mFakeXLinkKai.local_endpoint().port()));
+        ASSERT_TRUE(mConnection.Connect());
+        ASSERT_EQ(ReceiveDatagram(), XLinkKai_Constants::cConnectString);
+
+        SendDatagram(XLinkKai_Constants::cConnectedString);
+        ASSERT_TRUE(mConnection.ReadNextData());
+
+        // The receiver thread sends the settings once it is up and running
+        ASSERT_EQ(ReceiveDatagram(), XLinkKai_Constants::cSettingDDSOnlyString);
+    }
+
+    io_service         mIoService{};
+    ip::udp::socket    mFakeXLinkKai{mIoService, ip::udp::endpoint(ip::address_v4::loopback(), 0)};
+    ip::udp::endpoint  mXLHAEndpoint{};
+    XLinkKaiConnection mConnection{};
+};
+
+// Ethernet data should arrive at XLink Kai as a single e;e; datagram.
+TEST_F(XLinkKaiConnectionTest, SendEthernetData)
+{
+    Connect();
+
+    const std::string lFrame{"\xff\xff\xff\xff\xff\xff\x01\x02\x03\x04\x05\x06\x88\xc8payload", 21};
+    ASSERT_TRUE(mConnection.Send(lFrame));
+
+    EXPECT_EQ(ReceiveDatagram(), XLinkKai_Constants::cEthernetDataString + lFrame);
+
+    mConnection.Close();
+}
+
+// A burst of ethernet frames, larger than a single receive batch, should all be queued on the device in order.
+TEST_F(XLinkKaiConnectionTest, ReceiveEthernetDataBurst)
+{
+    constexpr unsigned int cAmountOfFrames{(cReceiveBatchSize * 2) + 3};
+
+    std::shared_ptr<IPCapDeviceMock> lDevice{std::make_shared<IPCapDeviceMock>()};
+    std::atomic<unsigned int>        lFramesReceived{0};
+    bool                             lInOrder{true};
+
+    EXPECT_CALL(*lDevice, BlackList(_)).Times(cAmountOfFrames);
+    EXPECT_CALL(*lDevice, Flush()).Times(::testing::AtLeast(1)).WillRepeatedly(Return(true));
+    EXPECT_CALL(*lDevice, Queue(_)).Times(cAmountOfFrames).WillRepeatedly(Invoke([&](std::string_view aData) {
+        // The last byte of the payload holds the index of the frame
+        lInOrder &= (static_cast<unsigned char>(aData.back()) == lFramesReceived);
+        lFramesReceived++;
+        return true;
+    }));
+
+    mConnection.SetIncomingConnection(lDevice);
+    Connect();
+
+    std::string lFrame{"\xff\xff\xff\xff\xff\xff\x01\x02\x03\x04\x05\x06\x88\xc8payload\x00", 22};
+    for (unsigned int lCount = 0; lCount < cAmountOfFrames; lCount++) {
+        lFrame.back() = static_cast<char>(lCount);
+        SendDatagram(XLinkKai_Constants::cEthernetDataString + lFrame);
+    }
+
+    for (unsigned int lTries = 0; lTries < 200 && lFramesReceived < cAmountOfFrames; lTries++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    mConnection.Close();
+
+    EXPECT_EQ(lFramesReceived, cAmountOfFrames);
+    EXPECT_TRUE(lInOrder);
+}
+
+// Commands should only be recognized by their full prefix, a keepalive should be answered and a disconnect should make
+// the connection reconnect.
+TEST_F(XLinkKaiConnectionTest, ReceiveCommands)
+{
+    std::shared_ptr<IPCapDeviceMock> lDevice{std::make_shared<IPCapDeviceMock>()};
+
+    EXPECT_CALL(*lDevice, Flush()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*lDevice, Queue(_)).Times(0);
+
+    mConnection.SetIncomingConnection(lDevice);
+    Connect();
+
+    SendDatagram("e;x;\xff\xff\xff\xff\xff\xff");
+    SendDatagram("keep;");
+    SendDatagram(XLinkKai_Constants::cKeepAliveString);
+    EXPECT_EQ(ReceiveDatagram(), XLinkKai_Constants::cKeepAliveString);
+
+    SendDatagram(XLinkKai_Constants::cDisconnectedString);
+    EXPECT_EQ(ReceiveDatagram(), XLinkKai_Constants::cConnectString);
+
+    mConnection.Close();
+}
+
+#ifdef __linux__
+// When driven by a reactor, the connection should connect on its own timer and deliver frames without its own threads.
+TEST_F(XLinkKaiConnectionTest, ReactorMode)
+{
+    std::shared_ptr<IPCapDeviceMock> lDevice{std::make_shared<IPCapDeviceMock>()};
+    std::shared_ptr<Reactor>         lReactor{std::make_shared<Reactor>()};
+    std::atomic<bool>                lFrameReceived{false};
+
+    const std::string lFrame{"\xff\xff\xff\xff\xff\xff\x01\x02\x03\x04\x05\x06\x88\xc8payload", 21};
+
+    EXPECT_CALL(*lDevice, BlackList(_));
+    EXPECT_CALL(*lDevice, Flush()).Times(::testing::AtLeast(1)).WillRepeatedly(Return(true));
+    EXPECT_CALL(*lDevice, Queue(std::string_view(lFrame))).WillOnce(Invoke([&](std::string_view /*aData*/) {
+        lFrameReceived = true;
+        return true;
+    }));
+
+    mConnection.SetIncomingConnection(lDevice);
+    ASSERT_TRUE(mConnection.Open("127.0.0.1", mFakeXLinkKai.local_endpoint().port()));
+    ASSERT_TRUE(mConnection.AddToReactor(lReactor));
+    ASSERT_TRUE(lReactor->Start());
+
+    // The connection timer reconnects, which also registers the reopened socket with the reactor
+    ASSERT_EQ(ReceiveDatagram(), XLinkKai_Constants::cConnectString);
+    SendDatagram(XLinkKai_Constants::cConnectedString);
+    ASSERT_EQ(ReceiveDatagram(), XLinkKai_Constants::cSettingDDSOnlyString);
+
+    SendDatagram(XLinkKai_Constants::cEthernetDataString + lFrame);
+
+    for (unsigned int lTries = 0; lTries < 200 && !lFrameReceived; lTries++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    lReactor->Stop();
+    mConnection.Close();
+
+    EXPECT_TRUE(lFrameReceived);
+}
+#endif
@@ -0,0 +1,121 @@
+/* Copyright (c) 2021 [Rick de Bondt] - XdpWrapperLinux_Test.cpp
+ * This file contains tests for the XdpWrapper class, these need permission to attach XDP programs to loopback.
+ **/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "NetConversionFunctions.h"
+#include "XdpWrapperLinux.h"
+
+namespace
+{
+    // Local experimental ethertypes, nothing else on loopback uses them
+    constexpr uint16_t         cEtherType{0xb588};
+    constexpr std::string_view cHeader{"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x88\xb5", 14};
+    constexpr std::string_view cOtherHeader{"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x88\xb6", 14};
+    constexpr std::string_view cPassedHeader{"\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00\x00\x01\x88\xb5", 14};
+
+    std::string MakeFrame(std::string_view aHeader, int aIndex)
+    {
+        return std::string(aHeader) + "XdpWrapperTest" + std::to_string(aIndex);
+    }
+}  // namespace
+
+class XdpWrapperTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+        mWrapper.Create("lo", lErrorBuffer.data());
+        mWrapper.SetTimeOut(10);
+        if (mWrapper.Activate() != 0) {
+            GTEST_SKIP() << "Can't use AF_XDP on loopback: " << mWrapper.GetError();
+        }
+    }
+
+    std::vector<std::string> Receive(size_t aAmount)
+    {
+        std::vector<std::string> lFrames{};
+
+        auto lCallback = [](unsigned char* aFrames, const pcap_pkthdr* aHeader, const unsigned char* aPacket) {
+            reinterpret_cast<std::vector<std::string>*>(aFrames)->emplace_back(reinterpret_cast<const char*>(aPacket),
+                                                                                aHeader->caplen);
+        };
+
+        for (int lTries = 0; lTries < 20 && lFrames.size() < aAmount; lTries++) {
+            mWrapper.Dispatch(-1, lCallback, reinterpret_cast<unsigned char*>(&lFrames));
+        }
+
+        return lFrames;
+    }
+
+    XdpWrapper mWrapper{{cEtherType}};
+};
+
+// Only frames with our ethertype should be redirected to the socket, in the order they were sent.
+TEST_F(XdpWrapperTest, SendAndReceive)
+{
+    std::vector<std::string> lOurs{MakeFrame(cHeader, 0), MakeFrame(cHeader, 1), MakeFrame(cHeader, 2)};
+    std::vector<std::string> lSent{lOurs.at(0), MakeFrame(cOtherHeader, 0), lOurs.at(1), lOurs.at(2)};
+    ASSERT_EQ(mWrapper.SendBatch(lSent), 4);
+
+    EXPECT_EQ(Receive(lOurs.size()), lOurs);
+    EXPECT_TRUE(Receive(1).empty());
+
+    // Only redirected frames are counted
+    pcap_stat lStatistics{};
+    ASSERT_EQ(mWrapper.GetStatistics(&lStatistics), 0);
+    EXPECT_EQ(lStatistics.ps_recv, lOurs.size());
+    EXPECT_EQ(lStatistics.ps_drop, 0);
+}
+
+// Batches bigger than the transmit ring should be sent in parts, and every frame should come back.
+TEST_F(XdpWrapperTest, LargeBatch)
+{
+    std::vector<std::string> lSent{};
+    for (unsigned int lCount = 0; lCount < XdpWrapper_Constants::cRingSize + 100; lCount++) {
+        lSent.emplace_back(MakeFrame(cHeader, static_cast<int>(lCount)));
+    }
+
+    ASSERT_EQ(mWrapper.SendBatch({lSent.begin(), lSent.begin() + XdpWrapper_Constants::cRingSize / 2}),
+              XdpWrapper_Constants::cRingSize / 2);
+    EXPECT_EQ(Receive(XdpWrapper_Constants::cRingSize / 2).size(), XdpWrapper_Constants::cRingSize / 2);
+
+    ASSERT_EQ(mWrapper.SendBatch(lSent), static_cast<int>(lSent.size()));
+    EXPECT_EQ(mWrapper.SendPacket(std::string(XdpWrapper_Constants::cFrameSize + 1, 'x')), PCAP_ERROR);
+}
+
+// NextEx should return packets one by one, and 0 when nothing arrives.
+TEST_F(XdpWrapperTest, NextEx)
+{
+    ASSERT_EQ(mWrapper.SendPacket(MakeFrame(cHeader, 0)), 0);
+
+    pcap_pkthdr*         lHeader{nullptr};
+    const unsigned char* lData{nullptr};
+    int                  lResult{0};
+    for (int lTries = 0; lTries < 20 && lResult != 1; lTries++) {
+        lResult = mWrapper.NextEx(&lHeader, &lData);
+    }
+
+    ASSERT_EQ(lResult, 1);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(lData), lHeader->caplen), MakeFrame(cHeader, 0));
+
+    mWrapper.SetNonBlock(1);
+    EXPECT_EQ(mWrapper.NextEx(&lHeader, &lData), 0);
+}
+
+// Frames from passed sources should go to the kernel stack instead of the socket.
+TEST_F(XdpWrapperTest, PassedSources)
+{
+    ASSERT_EQ(mWrapper.SetPassedSources({MacToInt("02:00:00:00:00:01")}), 0);
+
+    std::vector<std::string> lSent{MakeFrame(cPassedHeader, 0), MakeFrame(cHeader, 0)};
+    ASSERT_EQ(mWrapper.SendBatch(lSent), 2);
+
+    EXPECT_EQ(Receive(1), std::vector<std::string>{MakeFrame(cHeader, 0)});
+    EXPECT_TRUE(Receive(1).empty());
+}
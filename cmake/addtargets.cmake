@@ -73,6 +73,27 @@ foreach (target IN ITEMS ${targets})
     endif ()
   endif ()
 
+  # Benchmark stuff
+  if (${target}_BENCH_SOURCES AND ENABLE_BENCHMARKS)
+    # Add all sources to the benchmarks
+
+    list(APPEND TMPBENCHSOURCES ${${target}_SOURCES})
+    list(FILTER TMPBENCHSOURCES EXCLUDE REGEX ".*${target}.cpp*")
+    list(FILTER TMPBENCHSOURCES EXCLUDE REGEX "main.cpp")
+
+    add_executable(${target}_BENCH ${${target}_BENCH_SOURCES} ${TMPBENCHSOURCES})
+    target_include_directories(${target}_BENCH PRIVATE ${${target}_INCLUDE_FOLDERS} ${${target}_BENCH_INCLUDE_FOLDERS})
+    target_link_libraries(${target}_BENCH benchmark::benchmark ${${target}_LIBRARIES})
+
+    if (${target}_COMPILE_DEFINITIONS)
+      target_compile_definitions(${target}_BENCH ${${target}_COMPILE_DEFINITIONS})
+    endif ()
+
+    if (${target}_DEPENDENCIES)
+      add_dependencies(${target}_BENCH ${${target}_DEPENDENCIES})
+    endif ()
+  endif ()
+
   if (AUTO_FORMAT)
     add_dependencies(${target} ${target}_clangformat)
   endif ()
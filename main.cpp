@@ -1,4 +1,7 @@
 #include <chrono>
+#include <climits>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -12,9 +15,16 @@
 #include "Includes/IPCapDevice.h"
 #undef timeout
 
+#include "Includes/LatencyStatistics.h"
 #include "Includes/Logger.h"
 #include "Includes/MonitorDevice.h"
 #include "Includes/NetConversionFunctions.h"
+#include "Includes/PCapWrapper.h"
+#include "Includes/Reactor.h"
+#ifdef __linux__
+#include "Includes/TPacketWrapperLinux.h"
+#include "Includes/XdpWrapperLinux.h"
+#endif
 #include "Includes/UserInterface/KeyboardController.h"
 #include "Includes/UserInterface/MainWindowController.h"
 #include "Includes/WirelessPSPPluginDevice.h"
@@ -26,6 +36,7 @@ namespace
     constexpr std::string_view cLogFileName{"log.txt"};
     constexpr bool             cLogToDisk{true};
     constexpr std::string_view cConfigFileName{"config.txt"};
+    constexpr std::string_view cLatencyFileName{"latency.txt"};
 
     // Indicates if the program should be running or not, used to gracefully exit the program.
     bool gRunning{true};
@@ -63,6 +74,53 @@ static void SignalHandler(const boost::system::error_code& aError, int aSignalNu
     }
 }
 
+// Overwrites the file with the latency statistics recorded so far
+static void WriteLatencyStatistics(const std::string& aFileName)
+{
+    std::ofstream lFile{aFileName};
+
+    if (lFile.is_open()) {
+        lFile << LatencyStatistics::GetInstance().ToString();
+        Logger::GetInstance().Log("Latency statistics written to " + aFileName, Logger::Level::INFO);
+    } else {
+        Logger::GetInstance().Log("Could not write latency statistics to " + aFileName, Logger::Level::ERROR);
+    }
+}
+
+// Creates the capture backend chosen in the config, falls back to libpcap where that backend is not available
+static std::shared_ptr<IPCapWrapper> CreateCaptureWrapper(const WindowModel& aWindowModel)
+{
+    std::shared_ptr<IPCapWrapper> lReturn{nullptr};
+
+#ifdef __linux__
+    if (aWindowModel.mCaptureBackend == WindowModel_Constants::CaptureBackend::TPacket) {
+        lReturn = std::make_shared<TPacketWrapper>(
+            static_cast<unsigned int>(std::stoi(aWindowModel.mTPacketBlockSizeKiB)) * 1024,
+            std::chrono::milliseconds(std::stoi(aWindowModel.mTPacketTimeOutMs)));
+        Logger::GetInstance().Log("Using TPACKET_V3 capture", Logger::Level::INFO);
+    } else if (aWindowModel.mCaptureBackend == WindowModel_Constants::CaptureBackend::Xdp) {
+        // Only the frames the device is going to forward are taken away from the kernel stack, the device passes the
+        // ones from the adapter itself and blacklisted sources back to it
+        if (aWindowModel.mConnectionMethod == WindowModel_Constants::ConnectionMethod::Plugin) {
+            lReturn = std::make_shared<XdpWrapper>(std::vector<uint16_t>{Net_Constants::cPSPEtherType});
+            Logger::GetInstance().Log("Using AF_XDP capture", Logger::Level::INFO);
+        } else if (aWindowModel.mConnectionMethod == WindowModel_Constants::ConnectionMethod::Promiscuous) {
+            lReturn = std::make_shared<XdpWrapper>(std::vector<uint16_t>{
+                Net_Constants::cPSPEtherType, Net_Constants::Arp::cEtherType, Net_Constants::IPv4::cEtherType});
+            Logger::GetInstance().Log("Using AF_XDP capture", Logger::Level::INFO);
+        } else {
+            Logger::GetInstance().Log("AF_XDP can't capture in monitor mode, using libpcap", Logger::Level::WARNING);
+        }
+    }
+#endif
+
+    if (lReturn == nullptr) {
+        lReturn = std::make_shared<PCapWrapper>();
+    }
+
+    return lReturn;
+}
+
 int main(int argc, char* argv[])
 {
     std::string lProgramPath{"./"};
@@ -91,6 +149,9 @@ int main(int argc, char* argv[])
     // clang-format off
     lDescription.add_options()
         ("help,h", "Shows this help message.")
+        ("latency,l", "Records how long packets take through every stage of the bridge, written to latency.txt on exit "
+                      "and on SIGUSR1 (not on Windows).")
+        ("reactor,r", "Runs capture, XLink Kai and their timers on a single thread (Linux only).")
         ("verbose,v", "Disables HUD and shows log directly on screen.");
     // clang-format on
     po::variables_map lVariableMap;
@@ -101,6 +162,8 @@ int main(int argc, char* argv[])
     } else {
         po::notify(lVariableMap);
 
+        const bool lUseReactor{lVariableMap.count("reactor") != 0U};
+
         bool                                  lContinue{true};
         std::vector<std::string>              lSSIDFilters{};
         std::shared_ptr<MainWindowController> lWindowController{nullptr};
@@ -110,6 +173,27 @@ int main(int argc, char* argv[])
         boost::asio::io_service lSignalIoService{};
         boost::asio::signal_set lSignals(lSignalIoService, SIGINT, SIGTERM);
         lSignals.async_wait(&SignalHandler);
+
+        const bool lRecordLatency{lVariableMap.count("latency") != 0U};
+        LatencyStatistics::GetInstance().SetEnabled(lRecordLatency);
+
+#if not defined(_WIN32) && not defined(_WIN64)
+        // Dump the latency statistics on demand, keeps listening until the program quits
+        boost::asio::signal_set                                    lLatencySignals(lSignalIoService);
+        std::function<void(const boost::system::error_code&, int)> lLatencySignalHandler{
+            [&](const boost::system::error_code& aError, int /*aSignalNumber*/) {
+                if (!aError) {
+                    WriteLatencyStatistics(lProgramPath + cLatencyFileName.data());
+                    lLatencySignals.async_wait(lLatencySignalHandler);
+                }
+            }};
+
+        if (lRecordLatency) {
+            lLatencySignals.add(SIGUSR1);
+            lLatencySignals.async_wait(lLatencySignalHandler);
+        }
+#endif
+
         std::thread lThread{[lIoService = &lSignalIoService] { lIoService->run(); }};
 
         WindowModel mWindowModel{};
@@ -152,12 +236,14 @@ int main(int argc, char* argv[])
         if (lContinue) {
             std::shared_ptr<IPCapDevice>        lDevice{nullptr};
             std::shared_ptr<XLinkKaiConnection> lXLinkKaiConnection{std::make_shared<XLinkKaiConnection>()};
+            std::shared_ptr<Reactor>            lReactor{nullptr};
 
             bool lSuccess{false};
 
             // If we need more entry methods, make an actual state machine
             bool                                               lWaitEntry{true};
             std::chrono::time_point<std::chrono::system_clock> lWaitStart{std::chrono::seconds{0}};
+            IPCapDevice_Constants::CaptureStatistics           lCaptureStatistics{};
 
             while (gRunning) {
                 if (lWindowController == nullptr || lWindowController->Process()) {
@@ -170,36 +256,47 @@ int main(int argc, char* argv[])
 
                             switch (mWindowModel.mConnectionMethod) {
                                 case WindowModel_Constants::ConnectionMethod::Plugin:
+                                    LatencyStatistics::GetInstance().SetConnectionMethod(
+                                        LatencyStatistics_Constants::ConnectionMethod::Plugin);
                                     if (std::dynamic_pointer_cast<WirelessPSPPluginDevice>(lDevice) == nullptr) {
                                         std::chrono::seconds lTimeOut =
                                             std::chrono::seconds(std::stoi(mWindowModel.mReConnectionTimeOutS));
                                         lDevice = std::make_shared<WirelessPSPPluginDevice>(
                                             mWindowModel.mAutoDiscoverPSPVitaNetworks,
                                             lTimeOut,
-                                            &mWindowModel.mCurrentlyConnectedNetwork);
+                                            &mWindowModel.mCurrentlyConnectedNetwork,
+                                            std::make_shared<HandlerPSPPlugin>(),
+                                            CreateCaptureWrapper(mWindowModel));
 
                                         Logger::GetInstance().Log("Plugin Device created!", Logger::Level::INFO);
                                     }
                                     break;
                                 case WindowModel_Constants::ConnectionMethod::Promiscuous:
+                                    LatencyStatistics::GetInstance().SetConnectionMethod(
+                                        LatencyStatistics_Constants::ConnectionMethod::Promiscuous);
                                     if (std::dynamic_pointer_cast<WirelessPromiscuousDevice>(lDevice) == nullptr) {
                                         std::chrono::seconds lTimeOut =
                                             std::chrono::seconds(std::stoi(mWindowModel.mReConnectionTimeOutS));
                                         lDevice = std::make_shared<WirelessPromiscuousDevice>(
                                             mWindowModel.mAutoDiscoverPSPVitaNetworks,
                                             lTimeOut,
-                                            &mWindowModel.mCurrentlyConnectedNetwork);
+                                            &mWindowModel.mCurrentlyConnectedNetwork,
+                                            std::make_shared<Handler8023>(),
+                                            CreateCaptureWrapper(mWindowModel));
 
                                         Logger::GetInstance().Log("Promiscuous Device created!", Logger::Level::INFO);
                                     }
                                     break;
 #if not defined(_WIN32) && not defined(_WIN64)
                                 case WindowModel_Constants::ConnectionMethod::Monitor:
+                                    LatencyStatistics::GetInstance().SetConnectionMethod(
+                                        LatencyStatistics_Constants::ConnectionMethod::Monitor);
                                     if (std::dynamic_pointer_cast<MonitorDevice>(lDevice) == nullptr) {
                                         lDevice =
                                             std::make_shared<MonitorDevice>(MacToInt(mWindowModel.mOnlyAcceptFromMac),
                                                                             mWindowModel.mAcknowledgeDataFrames,
-                                                                            &mWindowModel.mCurrentlyConnectedNetwork);
+                                                                            &mWindowModel.mCurrentlyConnectedNetwork,
+                                                                            CreateCaptureWrapper(mWindowModel));
                                         Logger::GetInstance().Log("Monitor Device created!", Logger::Level::INFO);
                                     }
 				    break;
@@ -216,6 +313,15 @@ int main(int argc, char* argv[])
                             lDevice->SetConnector(lXLinkKaiConnection);
                             lDevice->SetHosting(mWindowModel.mHosting);
 
+                            // The backends take the size as an int, 0 keeps their default
+                            if (const int lBufferSizeKiB{std::stoi(mWindowModel.mCaptureBufferSizeKiB)};
+                                lBufferSizeKiB > 0 && lBufferSizeKiB <= INT_MAX / 1024) {
+                                lDevice->SetCaptureBufferSize(static_cast<unsigned int>(lBufferSizeKiB) * 1024);
+                            } else if (lBufferSizeKiB != 0) {
+                                Logger::GetInstance().Log("CaptureBufferSizeKiB out of range, using the default",
+                                                          Logger::Level::WARNING);
+                            }
+
                             // If we are auto discovering PSP/VITA networks add those to the filter list
                             if (mWindowModel.mAutoDiscoverPSPVitaNetworks) {
                                 lSSIDFilters.emplace_back(Net_Constants::cPSPSSIDFilterName.data());
@@ -233,7 +339,17 @@ int main(int argc, char* argv[])
                             // Now set up the wifi interface
                             if (lSuccess) {
                                 if (lDevice->Open(mWindowModel.mWifiAdapter, lSSIDFilters)) {
-                                    if (lDevice->StartReceiverThread() && lXLinkKaiConnection->StartReceiverThread()) {
+                                    bool lStarted{false};
+                                    if (lUseReactor) {
+                                        lReactor = std::make_shared<Reactor>();
+                                        lStarted = lDevice->AddToReactor(lReactor) &&
+                                                   lXLinkKaiConnection->AddToReactor(lReactor) && lReactor->Start();
+                                    } else {
+                                        lStarted = lDevice->StartReceiverThread() &&
+                                                   lXLinkKaiConnection->StartReceiverThread();
+                                    }
+
+                                    if (lStarted) {
                                         mWindowModel.mEngineStatus = WindowModel_Constants::EngineStatus::Running;
                                         mWindowModel.mCommand      = WindowModel_Constants::Command::NoCommand;
                                     } else {
@@ -275,15 +391,24 @@ int main(int argc, char* argv[])
                             }
                             break;
                         case WindowModel_Constants::Command::StopEngine:
-                            lXLinkKaiConnection->Close();
+                            // Nothing may be running on the reactor anymore while closing
+                            if (lReactor != nullptr) {
+                                lReactor->Stop();
+                            }
+
+                            // The device hands packets to XLink Kai from its capture thread, so close it first
                             lDevice->Close();
+                            lXLinkKaiConnection->Close();
                             lSSIDFilters.clear();
 
                             // Let's actually just remove the device, easier this way
-                            lDevice = nullptr;
+                            lDevice  = nullptr;
+                            lReactor = nullptr;
 
-                            mWindowModel.mEngineStatus = WindowModel_Constants::EngineStatus::Idle;
-                            mWindowModel.mCommand      = WindowModel_Constants::Command::NoCommand;
+                            lCaptureStatistics              = {};
+                            mWindowModel.mCaptureStatistics = "";
+                            mWindowModel.mEngineStatus      = WindowModel_Constants::EngineStatus::Idle;
+                            mWindowModel.mCommand           = WindowModel_Constants::Command::NoCommand;
                             break;
                         case WindowModel_Constants::Command::StartSearchNetworks:
                         case WindowModel_Constants::Command::StopSearchNetworks:
@@ -305,6 +430,18 @@ int main(int argc, char* argv[])
                             }
                             break;
                         case WindowModel_Constants::Command::NoCommand:
+                            // Only rebuild the status when the device collected new statistics
+                            if (lDevice != nullptr &&
+                                mWindowModel.mEngineStatus == WindowModel_Constants::EngineStatus::Running &&
+                                lDevice->GetCaptureStatistics() != lCaptureStatistics) {
+                                lCaptureStatistics              = lDevice->GetCaptureStatistics();
+                                mWindowModel.mCaptureStatistics = "Captured: " +
+                                                                  std::to_string(lCaptureStatistics.Received) +
+                                                                  " Dropped: " +
+                                                                  std::to_string(lCaptureStatistics.Dropped) +
+                                                                  " Interface dropped: " +
+                                                                  std::to_string(lCaptureStatistics.InterfaceDropped);
+                            }
                             break;
                     }
                 } else {
@@ -315,6 +452,10 @@ int main(int argc, char* argv[])
             mWindowModel.mEngineStatus = WindowModel_Constants::EngineStatus::Idle;
             mWindowModel.mCommand      = WindowModel_Constants::Command::NoCommand;
 
+            if (lReactor != nullptr) {
+                lReactor->Stop();
+            }
+
             if (lDevice != nullptr) {
                 lDevice->Close();
             }
@@ -324,6 +465,7 @@ int main(int argc, char* argv[])
 
             lDevice             = nullptr;
             lXLinkKaiConnection = nullptr;
+            lReactor            = nullptr;
         } else {
             gRunning = false;
         }
@@ -339,5 +481,9 @@ int main(int argc, char* argv[])
         if (lThread.joinable()) {
             lThread.join();
         }
+
+        if (lRecordLatency) {
+            WriteLatencyStatistics(lProgramPath + cLatencyFileName.data());
+        }
     }
 }